@@ -0,0 +1,144 @@
+#include "order.hpp"
+#include "order_book.hpp"
+#include "runtime.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Measures the round trip of placeOrder from several caller threads, in blocking mode and then in busy-poll mode, so
+// that their tail latencies can be compared. Busy-poll mode only pays off when the matching thread and each caller
+// have an isolated core, so pass cores that nothing else runs on (e.g. ones reserved with isolcpus).
+// Usage: broka_latency_bench [--callers N] [--orders N] [--spin pause|yield|backoff] [--matching-core N]
+//                            [--housekeeping-core N] [--caller-core N]
+
+namespace {
+constexpr Price price { 100 };
+
+struct BenchOptions {
+    std::size_t callers { 2 };
+    std::size_t orders { 200'000 }; // Per caller.
+    int callerCore { -1 }; // First core to pin callers to, consecutively.
+    OrderBookOptions bookOptions;
+};
+
+auto percentile(std::span<const std::chrono::nanoseconds> sorted, double fraction) -> std::int64_t
+{
+    const auto index { static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1)) };
+    return sorted[index].count();
+}
+
+auto measure(const char* name, ThreadingModel threadingModel, const BenchOptions& options) -> void
+{
+    using namespace std::chrono; // NOLINT(google-build-using-namespace)
+
+    auto bookOptions { options.bookOptions };
+    bookOptions.threadingModel = threadingModel;
+    OrderBook orderBook { bookOptions };
+
+    // Each caller alternates buys and sells at one price, so half of its orders trade and the book stays shallow.
+    std::vector<std::vector<nanoseconds>> latencies(options.callers);
+    std::vector<std::thread> callers;
+    const auto start { steady_clock::now() };
+    for (std::size_t caller { 0 }; caller < options.callers; ++caller) {
+        callers.emplace_back([&orderBook, &latencies, &options, caller] {
+            auto& callerLatencies { latencies[caller] };
+            callerLatencies.reserve(options.orders);
+            for (std::size_t i { 0 }; i < options.orders; ++i) {
+                const auto id { static_cast<OrderId>(caller * options.orders + i + 1) };
+                auto order { std::make_shared<Order>(id, OrderType::gtc, i % 2 == 0 ? Side::buy : Side::sell, price, 1) };
+
+                const auto sent { steady_clock::now() };
+                auto discard { orderBook.placeOrder(order) };
+                callerLatencies.emplace_back(steady_clock::now() - sent);
+            }
+        });
+        if (options.callerCore >= 0) {
+            pinThread(callers.back(), options.callerCore + static_cast<int>(caller));
+        }
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    const auto elapsed { duration<double> { steady_clock::now() - start }.count() };
+
+    std::vector<nanoseconds> sorted;
+    for (const auto& callerLatencies : latencies) {
+        sorted.insert(sorted.end(), callerLatencies.begin(), callerLatencies.end());
+    }
+    std::ranges::sort(sorted);
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-vararg)
+    std::printf("%-9s %zu calls in %.2f s (%.0f/s)\n", name, sorted.size(), elapsed, static_cast<double>(sorted.size()) / elapsed);
+    std::printf("  p50 %" PRId64 " ns, p99 %" PRId64 " ns, p99.9 %" PRId64 " ns, max %" PRId64 " ns\n", percentile(sorted, 0.5),
+        percentile(sorted, 0.99), percentile(sorted, 0.999), percentile(sorted, 1.0));
+    // NOLINTEND(cppcoreguidelines-pro-type-vararg)
+}
+
+auto parseSpinPolicy(std::string_view name) -> std::optional<SpinPolicy>
+{
+    if (name == "pause") {
+        return SpinPolicy::pause;
+    }
+    if (name == "yield") {
+        return SpinPolicy::yield;
+    }
+    if (name == "backoff") {
+        return SpinPolicy::backoff;
+    }
+    return std::nullopt;
+}
+
+auto parseBenchOptions(std::span<char*> flags) -> std::optional<BenchOptions>
+{
+    BenchOptions options;
+    for (std::size_t i { 0 }; i < flags.size(); ++i) {
+        const std::string_view flag { flags[i] };
+        if (i + 1 >= flags.size()) {
+            return std::nullopt;
+        }
+        const std::string_view value { flags[++i] };
+        if (flag == "--callers") {
+            options.callers = std::max(std::stoul(std::string { value }), 1UL);
+        } else if (flag == "--orders") {
+            options.orders = std::max(std::stoul(std::string { value }), 1UL);
+        } else if (flag == "--spin" && parseSpinPolicy(value)) {
+            options.bookOptions.spinPolicy = *parseSpinPolicy(value);
+        } else if (flag == "--matching-core") {
+            options.bookOptions.matchingCore = std::stoi(std::string { value });
+        } else if (flag == "--housekeeping-core") {
+            options.bookOptions.housekeepingCore = std::stoi(std::string { value });
+        } else if (flag == "--caller-core") {
+            options.callerCore = std::stoi(std::string { value });
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    const std::span args { argv, static_cast<std::size_t>(argc) };
+
+    const auto options { parseBenchOptions(args.subspan(1)) };
+    if (!options) {
+        std::fprintf(stderr, "usage: %s [--callers N] [--orders N] [--spin pause|yield|backoff] [--matching-core N] " // NOLINT(cppcoreguidelines-pro-type-vararg)
+                             "[--housekeeping-core N] [--caller-core N]\n",
+            args[0]);
+        return 1;
+    }
+
+    measure("blocking", ThreadingModel::blocking, *options);
+    measure("busy-poll", ThreadingModel::busyPoll, *options);
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "order.hpp"
+#include "order_book.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Fills a book with resting orders and reports the bytes each one costs, so that memory reduction work can be tracked.
+// Usage: broka_memory_bench [order count...] (defaults to 1M, 10M and 50M orders).
+
+namespace {
+constexpr Price midPrice { 100000 };
+constexpr Price levelsPerSide { 1000 };
+
+auto residentBytes() -> std::size_t
+{
+    std::ifstream statm { "/proc/self/statm" };
+    std::size_t totalPages { 0 };
+    std::size_t residentPages { 0 };
+    statm >> totalPages >> residentPages;
+    return residentPages * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+auto perOrder(std::size_t bytes, std::size_t orders) -> double
+{
+    return static_cast<double>(bytes) / static_cast<double>(orders);
+}
+
+auto measure(std::size_t count) -> void
+{
+    using namespace std::chrono; // NOLINT(google-build-using-namespace)
+
+    const auto residentBefore { residentBytes() };
+    const auto start { steady_clock::now() };
+
+    // Bids and asks never cross, so every order rests.
+    OrderBook orderBook { { .threadingModel = ThreadingModel::confined } };
+    for (std::size_t i { 0 }; i < count; ++i) {
+        const auto id { static_cast<OrderId>(i + 1) };
+        const auto offset { static_cast<Price>(i / 2 % levelsPerSide) };
+        const auto side { i % 2 == 0 ? Side::buy : Side::sell };
+        const auto price { side == Side::buy ? midPrice - 1 - offset : midPrice + offset };
+        auto discard { orderBook.placeOrder(std::make_shared<Order>(id, OrderType::gtc, side, price, 1)) };
+    }
+
+    const auto elapsed { duration<double> { steady_clock::now() - start }.count() };
+    const auto stats { orderBook.memoryStats() };
+    const auto resident { residentBytes() - residentBefore };
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-vararg)
+    std::printf("%zu resting orders, %zu levels, filled in %.2f s\n", stats.liveOrders, stats.bidLevels + stats.askLevels, elapsed);
+    std::printf("  level nodes:    %8.2f bytes/order\n", perOrder(stats.bidLevelNodes.bytes + stats.askLevelNodes.bytes, count));
+    std::printf("  level arrays:   %8.2f bytes/order\n", perOrder(stats.levelArrays.bytes, count));
+    std::printf("  order index:    %8.2f bytes/order (%zu buckets, load factor %.2f)\n",
+        perOrder(stats.orderIndex.bytes, count), stats.indexBuckets, stats.indexLoadFactor);
+    std::printf("  book total:     %8.2f bytes/order (peak %.2f)\n", perOrder(stats.bookBytes(), count), perOrder(stats.peakBookBytes, count));
+    std::printf("  caller orders:  %8.2f bytes/order (estimated)\n", perOrder(stats.callerOrderBytes, count));
+    std::printf("  resident delta: %8.2f bytes/order\n", perOrder(resident, count));
+    // NOLINTEND(cppcoreguidelines-pro-type-vararg)
+}
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    const std::span args { argv, static_cast<std::size_t>(argc) };
+
+    std::vector<std::size_t> counts { 1'000'000, 10'000'000, 50'000'000 };
+    if (args.size() > 1) {
+        counts.clear();
+        for (const auto* arg : args.subspan(1)) {
+            counts.emplace_back(std::stoul(arg));
+        }
+    }
+
+    for (const auto count : counts) {
+        measure(count);
+    }
+    return 0;
+}
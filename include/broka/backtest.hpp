@@ -0,0 +1,48 @@
+#pragma once
+#include "capture.hpp"
+#include "common.hpp"
+#include "order_book.hpp"
+#include "trade.hpp"
+#include "trade_stats.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <thread>
+#include <vector>
+
+struct InstrumentStream {
+    InstrumentId instrument {};
+    Events events;
+};
+
+using InstrumentStreams = std::vector<InstrumentStream>;
+
+// Groups events by instrument, preserving their relative order. Streams are returned in instrument order.
+[[nodiscard]] auto splitByInstrument(std::span<const Event> events) -> InstrumentStreams;
+
+struct BacktestOptions {
+    std::size_t threads { std::thread::hardware_concurrency() };
+    std::size_t batchSize { 4096 }; // Events applied to a book before its task yields to the scheduler.
+    OrderBookOptions bookOptions; // Always confined, with trades timestamped by capture time.
+};
+
+struct BookResult {
+    InstrumentId instrument {};
+    std::size_t eventCount {};
+    std::size_t restingOrders {};
+    Trades trades;
+    Bar session; // Trade statistics for the whole stream.
+};
+
+struct BacktestResult {
+    std::vector<BookResult> books; // In the same order as the input streams.
+    std::size_t eventCount {};
+    std::size_t tradeCount {};
+    std::uint64_t volume {};
+    std::uint64_t bookDigest {}; // Matches Replayer::bookDigest() for the same events.
+    std::uint64_t tradeDigest {}; // Covers each book's trades in turn, so is independent of scheduling.
+};
+
+// Replays each stream into its own order book. Each book's stream runs as a chain of tasks on a work-stealing pool, so
+// a book is only touched by one thread at a time and never needs to lock.
+[[nodiscard]] auto runBacktest(std::span<const InstrumentStream> streams, const BacktestOptions& options = {}) -> BacktestResult;
@@ -0,0 +1,78 @@
+#pragma once
+#include "common.hpp"
+#include "order.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <span>
+#include <vector>
+
+using InstrumentId = std::uint32_t;
+
+enum class EventKind : std::uint8_t {
+    place,
+    cancel,
+    modify,
+};
+
+// Fixed-width on-disk record, so a capture can be memory-mapped and read in place.
+struct Event {
+    Timestamp timestamp {}; // Only meaningful relative to other events in the same capture.
+    InstrumentId instrument {};
+    OrderId id {};
+    Price price {};
+    Quantity quantity {};
+    EventKind kind {};
+    std::uint8_t type {}; // OrderType, only used by place events.
+    std::uint8_t side {}; // Side, only used by place events.
+    std::uint8_t reserved {};
+    std::uint32_t padding {};
+
+    [[nodiscard]] auto orderType() const -> OrderType { return static_cast<OrderType>(type); }
+    [[nodiscard]] auto orderSide() const -> Side { return static_cast<Side>(side); }
+};
+
+static_assert(sizeof(Event) == 32);
+
+using Events = std::vector<Event>;
+
+struct CaptureHeader {
+    std::uint64_t magic {};
+    std::uint32_t version {};
+    std::uint32_t eventSize {};
+    std::uint64_t eventCount {};
+    std::uint64_t reserved {};
+};
+
+static_assert(sizeof(CaptureHeader) == 32);
+
+namespace Constants {
+inline constexpr std::uint64_t captureMagic { 0x504143414b4f5242 }; // "BROKACAP" read little-endian.
+inline constexpr std::uint32_t captureVersion { 1 };
+} // namespace Constants
+
+// Read-only memory mapping of a binary capture file. Throws std::runtime_error if the header or any event is invalid.
+class Capture {
+public:
+    explicit Capture(const std::filesystem::path& path);
+    ~Capture();
+
+    Capture(const Capture&) = delete;
+    auto operator=(const Capture&) -> Capture& = delete;
+    Capture(Capture&&) = delete;
+    auto operator=(Capture&&) -> Capture& = delete;
+
+    [[nodiscard]] auto events() const -> std::span<const Event> { return m_events; }
+
+private:
+    void* m_mapping { nullptr };
+    std::size_t m_mappingSize { 0 };
+    std::span<const Event> m_events;
+};
+
+// Expects lines of the form "timestamp,instrument,action,id,type,side,price,quantity". A leading header line is
+// skipped. Cancels only need an id, modifies need a price and quantity, and places need a side and quantity plus a
+// price unless they are market orders (an empty type means gtc). Throws std::runtime_error on malformed input.
+[[nodiscard]] auto parseCsv(std::istream& input) -> Events;
+auto writeCapture(const std::filesystem::path& path, std::span<const Event> events) -> void;
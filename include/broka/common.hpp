@@ -1,10 +1,14 @@
 #pragma once
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 
 using Price = unsigned int;
 using Quantity = unsigned int;
+using Timestamp = std::uint64_t; // Nanoseconds.
 
 namespace Constants {
+inline constexpr std::size_t cacheLineSize { 64 };
 inline constexpr Price invalidPrice { 0 };
 inline constexpr auto marketCloseHour { std::chrono::hours { 16 } };
 } // namespace Constants
@@ -0,0 +1,78 @@
+#pragma once
+#include "common.hpp"
+#include "order.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+using Ticket = std::uint32_t; // Orders within a level are stored in increasing ticket order.
+
+namespace Constants {
+inline constexpr unsigned ticketBits { 27 };
+inline constexpr Ticket maxTicket { (Ticket { 1 } << ticketBits) - 1 };
+inline constexpr std::size_t minLevelCompaction { 64 }; // Consumed orders at the front of a level before it is compacted.
+} // namespace Constants
+
+// The fields read by the matching loop, packed so that a level's orders can be scanned sequentially.
+struct HotOrder {
+    OrderId id;
+    Quantity remainingQuantity;
+    Price price;
+    Ticket ticket : Constants::ticketBits;
+    std::uint32_t side : 1;
+    std::uint32_t type : 3;
+    std::uint32_t dead : 1; // Set on tombstones, so that they never depend on the remaining quantity.
+
+    [[nodiscard]] auto orderSide() const -> Side { return static_cast<Side>(side); }
+    [[nodiscard]] auto orderType() const -> OrderType { return static_cast<OrderType>(type); }
+};
+
+static_assert(sizeof(HotOrder) == 16);
+
+// A FIFO queue of orders at a single price. The hot records live in one contiguous array and hold the authoritative
+// remaining quantities. The caller's orders are kept in a parallel array, and only the front's fills are written back
+// to its order, when it is popped or synced, so that filling never touches the caller's order.
+class alignas(Constants::cacheLineSize) Level {
+public:
+    [[nodiscard]] auto append(const OrderPtr& order) -> Ticket;
+    auto erase(Ticket ticket) -> void;
+    auto kill(Ticket ticket) -> void; // Leaves a tombstone, which is skipped by front() and removed by compact().
+    [[nodiscard]] auto find(Ticket ticket) const -> const HotOrder&;
+
+    [[nodiscard]] auto empty() const -> bool { return m_head == m_orders.size(); }
+    [[nodiscard]] auto front() const -> const HotOrder& { return m_orders[m_head]; }
+    auto fillFront(Quantity quantity) -> void;
+    auto popFront() -> void;
+    auto syncFront() -> void; // Writes the front's fills back to its order, which should be done once matching ends.
+
+    // May include tombstones, which are marked dead and have no remaining quantity.
+    [[nodiscard]] auto orders() const -> std::span<const HotOrder> { return std::span { m_orders }.subspan(m_head); }
+    [[nodiscard]] auto quantity() const -> Quantity { return m_quantity; }
+    [[nodiscard]] auto tombstones() const -> std::size_t { return m_tombstones; }
+    [[nodiscard]] auto allocatedBytes() const -> std::size_t // Only changes when appending.
+    {
+        return m_orders.capacity() * sizeof(HotOrder) + m_owners.capacity() * sizeof(OrderPtr);
+    }
+    [[nodiscard]] auto shouldCompact(double tombstoneRatio) const -> bool;
+    auto compact() -> void;
+
+    // Tickets are only unique within a level, so the caller must re-read them after renumbering.
+    [[nodiscard]] auto ticketsExhausted() const -> bool { return m_nextTicket > Constants::maxTicket; }
+    auto renumber() -> void;
+
+private:
+    Quantity m_quantity { 0 }; // Total remaining quantity across the level.
+    Ticket m_nextTicket { 0 };
+    std::uint32_t m_head { 0 }; // Orders before the head have been consumed and are awaiting compaction.
+    std::uint32_t m_tombstones { 0 }; // Cancelled orders after the head.
+    std::vector<HotOrder> m_orders;
+    std::vector<OrderPtr> m_owners;
+
+    [[nodiscard]] auto indexOf(Ticket ticket) const -> std::size_t;
+    auto syncOwner(std::size_t index) -> void;
+    auto compactFront() -> void;
+    auto dropConsumed() -> void;
+};
+
+static_assert(sizeof(Level) == Constants::cacheLineSize);
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+// Bytes currently held by a structure, and the most it has held at once. Not thread-safe, so should be guarded by
+// whatever guards the structure itself. Changes are forwarded to the parent, if any, so that it can track the peak of
+// several structures combined.
+class MemoryCounter {
+public:
+    explicit MemoryCounter(MemoryCounter* parent = nullptr)
+        : m_parent { parent }
+    {
+    }
+
+    auto allocate(std::size_t bytes) -> void
+    {
+        m_bytes += bytes;
+        m_peakBytes = std::max(m_peakBytes, m_bytes);
+        if (m_parent != nullptr) {
+            m_parent->allocate(bytes);
+        }
+    }
+    auto deallocate(std::size_t bytes) -> void
+    {
+        m_bytes -= bytes;
+        if (m_parent != nullptr) {
+            m_parent->deallocate(bytes);
+        }
+    }
+
+    [[nodiscard]] auto bytes() const -> std::size_t { return m_bytes; }
+    [[nodiscard]] auto peakBytes() const -> std::size_t { return m_peakBytes; }
+
+private:
+    MemoryCounter* m_parent;
+    std::size_t m_bytes { 0 };
+    std::size_t m_peakBytes { 0 };
+};
+
+// Standard allocator that records every allocation against a counter, if one is given.
+template <typename T>
+class AccountingAllocator {
+public:
+    using value_type = T;
+
+    explicit AccountingAllocator(MemoryCounter* counter = nullptr) noexcept
+        : m_counter { counter }
+    {
+    }
+
+    template <typename U>
+    AccountingAllocator(const AccountingAllocator<U>& other) noexcept // NOLINT(google-explicit-constructor)
+        : m_counter { other.counter() }
+    {
+    }
+
+    [[nodiscard]] auto allocate(std::size_t count) -> T*
+    {
+        const auto bytes { count * sizeof(T) };
+        void* memory {};
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            memory = ::operator new(bytes, std::align_val_t { alignof(T) });
+        } else {
+            memory = ::operator new(bytes);
+        }
+        if (m_counter != nullptr) {
+            m_counter->allocate(bytes);
+        }
+        return static_cast<T*>(memory);
+    }
+
+    auto deallocate(T* memory, std::size_t count) noexcept -> void
+    {
+        const auto bytes { count * sizeof(T) };
+        if (m_counter != nullptr) {
+            m_counter->deallocate(bytes);
+        }
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(memory, bytes, std::align_val_t { alignof(T) });
+        } else {
+            ::operator delete(memory, bytes);
+        }
+    }
+
+    [[nodiscard]] auto counter() const -> MemoryCounter* { return m_counter; }
+
+    template <typename U>
+    [[nodiscard]] auto operator==(const AccountingAllocator<U>& other) const -> bool
+    {
+        return m_counter == other.counter();
+    }
+
+private:
+    MemoryCounter* m_counter;
+};
@@ -1,6 +1,6 @@
 #pragma once
 #include "common.hpp"
-#include <deque>
+#include <cstddef>
 #include <memory>
 #include <vector>
 
@@ -57,7 +57,11 @@ private:
 };
 
 using OrderPtr = std::shared_ptr<Order>;
-using Orders = std::deque<OrderPtr>;
+
+namespace Constants {
+// Approximate size of a std::make_shared<Order> allocation: the order plus a control block with two reference counts.
+inline constexpr std::size_t sharedOrderBytes { sizeof(Order) + sizeof(void*) + 2 * sizeof(int) };
+} // namespace Constants
 using OrderIds = std::vector<OrderId>;
 
 class OrderUpdate {
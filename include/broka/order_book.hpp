@@ -1,12 +1,19 @@
 #pragma once
 #include "common.hpp"
+#include "level.hpp"
+#include "memory.hpp"
 #include "order.hpp"
+#include "runtime.hpp"
 #include "trade.hpp"
+#include "trade_stats.hpp"
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <map>
 #include <mutex>
+#include <optional>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -18,6 +25,36 @@ struct LevelInfo {
 
 using LevelsInfo = std::vector<LevelInfo>;
 
+struct MemoryUsage {
+    std::size_t bytes {};
+    std::size_t peakBytes {};
+};
+
+struct MemoryStats {
+    std::size_t liveOrders {};
+    std::size_t peakLiveOrders {};
+    std::size_t bidLevels {};
+    std::size_t askLevels {};
+    std::size_t peakLevels {}; // Across both sides.
+
+    MemoryUsage bidLevelNodes; // Map nodes, including the level headers.
+    MemoryUsage askLevelNodes;
+    MemoryUsage levelArrays; // Hot order records and the pointers to the caller's orders.
+    MemoryUsage orderIndex; // Hash nodes and buckets.
+    std::size_t indexBuckets {};
+    double indexLoadFactor {};
+
+    std::size_t peakBookBytes {}; // Of all the structures above combined, rather than the sum of their own peaks.
+
+    // Estimated, as the caller allocates each Order (typically alongside its shared_ptr control block).
+    std::size_t callerOrderBytes {};
+
+    [[nodiscard]] auto bookBytes() const -> std::size_t
+    {
+        return bidLevelNodes.bytes + askLevelNodes.bytes + levelArrays.bytes + orderIndex.bytes;
+    }
+};
+
 class OrderBookLevelsInfo {
 public:
     OrderBookLevelsInfo(LevelsInfo bidLevelsInfo, LevelsInfo askLevelsInfo)
@@ -34,9 +71,40 @@ private:
     LevelsInfo m_askLevelsInfo;
 };
 
+enum class ThreadingModel {
+    blocking, // Callers on any thread are serialised by a mutex, and day orders expire on a background thread.
+    confined, // The book is only ever used by one thread at a time, so no locks are taken and day orders never expire.
+    busyPoll, // A dedicated matching thread spins on a request queue, and callers spin until their request completes.
+};
+
+enum class CancelMode {
+    eager, // Cancelled orders are removed from their level immediately.
+    lazy, // Cancelled orders are left as tombstones and removed from their level in batches.
+};
+
+enum class TradeClock {
+    system, // Trades are timestamped with the wall clock when they occur.
+    manual, // Trades are timestamped with the last time given to setTime, e.g. a capture's event timestamps.
+};
+
+struct OrderBookOptions {
+    ThreadingModel threadingModel { ThreadingModel::blocking };
+    CancelMode cancelMode { CancelMode::eager };
+    double tombstoneRatio { 0.5 }; // Fraction of a level that may be tombstones before it is compacted (lazy mode only).
+    TradeClock tradeClock { TradeClock::system };
+    BarIntervals barIntervals { std::chrono::seconds { 1 }, std::chrono::minutes { 1 } };
+    std::size_t barHistory { 256 }; // Bars kept per interval.
+
+    // Busy-poll mode only, which needs isolated cores to beat blocking mode (e.g. isolcpus on Linux).
+    SpinPolicy spinPolicy { SpinPolicy::pause }; // How the matching thread and waiting callers spin.
+    std::size_t requestQueueCapacity { 1024 }; // Callers spin while the queue is full.
+    int matchingCore { -1 }; // Core the matching thread is pinned to, or -1 to leave it unpinned.
+    int housekeepingCore { -1 }; // Core the day order expiry thread is pinned to (blocking mode too).
+};
+
 class OrderBook {
 public:
-    OrderBook();
+    explicit OrderBook(const OrderBookOptions& options = {});
     ~OrderBook();
 
     // Prevent copying and moving to avoid concurrency complications.
@@ -47,34 +115,103 @@ public:
 
     auto cancelOrder(OrderId id) -> void;
     [[nodiscard]] auto levelsInfo() const -> OrderBookLevelsInfo;
+    [[nodiscard]] auto memoryStats() const -> MemoryStats;
     [[nodiscard]] auto placeOrder(const OrderPtr& order) -> Trades;
+    auto setTime(Timestamp time) -> void; // Ignored unless the trade clock is manual.
     [[nodiscard]] auto size() const -> std::size_t;
+    [[nodiscard]] auto tradeStats() const -> const TradeStats& { return m_tradeStats; } // Safe to read without locking.
     [[nodiscard]] auto updateOrder(const OrderUpdate& update) -> Trades;
 
 private:
     struct OrderEntry {
-        OrderPtr order;
-        Orders::iterator location; // Points to the order in the m_bids or m_asks orders deque.
+        Price price;
+        Side side;
+        Ticket ticket; // Locates the order within its level in m_bids or m_asks.
     };
 
-    std::map<Price, Orders, std::greater<>> m_bids;
-    std::map<Price, Orders> m_asks;
-    std::unordered_map<OrderId, OrderEntry> m_orders;
+    using LevelAllocator = AccountingAllocator<std::pair<const Price, Level>>;
+    using EntryAllocator = AccountingAllocator<std::pair<const OrderId, OrderEntry>>;
+
+    // Declared before the containers they count, so that they outlive them.
+    MemoryCounter m_bookMemory; // Parent of the counters below.
+    MemoryCounter m_bidMemory { &m_bookMemory };
+    MemoryCounter m_askMemory { &m_bookMemory };
+    MemoryCounter m_levelArrayMemory { &m_bookMemory }; // Updated by hand, as level arrays are only resized when appending.
+    MemoryCounter m_indexMemory { &m_bookMemory };
+    std::size_t m_peakOrders { 0 };
+    std::size_t m_peakLevels { 0 };
+
+    std::map<Price, Level, std::greater<>, LevelAllocator> m_bids;
+    std::map<Price, Level, std::less<>, LevelAllocator> m_asks;
+    std::unordered_map<OrderId, OrderEntry, std::hash<OrderId>, std::equal_to<>, EntryAllocator> m_orders;
+    OrderBookOptions m_options;
+    TradeStats m_tradeStats;
+    Timestamp m_time { 0 }; // Set by setTime for the manual trade clock.
 
     mutable std::mutex m_mutex;
     std::condition_variable m_shutdownCond;
     std::atomic<bool> m_shutdown;
     std::thread m_temporalThread; // Runs in the background to check for expired day orders.
 
+    mutable RequestQueue m_requests;
+    std::atomic<bool> m_stopMatching { false }; // Only set once nothing else can submit requests.
+    std::thread m_matchingThread; // Owns the book in busy-poll mode.
+
     auto cancelExpiredDayOrders() -> void;
-    auto cancelOrders(const OrderIds& ids) -> void;
+    auto pollRequests() -> void;
 
-    // Should only be called when holding the lock.
+    // Should only be called with exclusive access to the book, as granted by execute.
+    auto cancelDayOrdersNoLock() -> void;
     auto cancelOrderNoLock(OrderId id) -> void;
     [[nodiscard]] auto canFullyFillOrderNoLock(Side side, Price price, Quantity quantity) const -> bool;
     [[nodiscard]] auto canPartiallyFillOrderNoLock(Side side, Price price) const -> bool;
     [[nodiscard]] auto convertMarketOrderNoLock(const OrderPtr& order) -> bool;
+    [[nodiscard]] auto levelNoLock(Side side, Price price) -> Level&;
     [[nodiscard]] auto levelsInfoNoLock() const -> OrderBookLevelsInfo;
-    [[nodiscard]] auto matchOrdersNoLock() -> Trades;
+    [[nodiscard]] auto memoryStatsNoLock() const -> MemoryStats;
+    [[nodiscard]] auto matchOrdersNoLock(Side aggressor) -> Trades;
     [[nodiscard]] auto placeOrderNoLock(const OrderPtr& order) -> Trades;
+    auto renumberLevelNoLock(Level& level) -> void;
+    [[nodiscard]] auto tradeTimeNoLock() const -> Timestamp;
+    [[nodiscard]] auto updateOrderNoLock(const OrderUpdate& update) -> Trades;
+
+    // Runs an operation with exclusive access to the book, as required by the threading model.
+    template <typename Operation>
+    auto execute(Operation operation) const -> decltype(operation())
+    {
+        using Result = decltype(operation());
+
+        if (m_options.threadingModel == ThreadingModel::confined) {
+            return operation();
+        }
+        if (m_options.threadingModel == ThreadingModel::busyPoll) {
+            if constexpr (std::is_void_v<Result>) {
+                handOff(operation);
+                return;
+            } else {
+                std::optional<Result> result;
+                auto store = [&operation, &result] { result.emplace(operation()); };
+                handOff(store);
+                return std::move(*result);
+            }
+        }
+        std::lock_guard lock { m_mutex };
+        return operation();
+    }
+
+    // Runs an operation on the matching thread, spinning until it has completed.
+    template <typename Operation>
+    auto handOff(Operation& operation) const -> void
+    {
+        Request request { [](void* context) { (*static_cast<Operation*>(context))(); }, &operation };
+        Spinner spinner { m_options.spinPolicy };
+
+        while (!m_requests.tryPush(&request)) {
+            spinner.spin();
+        }
+        spinner.reset();
+        while (!request.done.load(std::memory_order_acquire)) {
+            spinner.spin();
+        }
+    }
 };
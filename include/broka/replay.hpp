@@ -0,0 +1,49 @@
+#pragma once
+#include "capture.hpp"
+#include "common.hpp"
+#include "order_book.hpp"
+#include "trade.hpp"
+#include <cstdint>
+#include <map>
+#include <memory>
+
+// Order-sensitive FNV-1a hash, used to check that two runs over the same capture ended in the same state.
+class Digest {
+public:
+    auto add(std::uint64_t value) -> void;
+    auto add(const Trade& trade) -> void;
+    auto add(const OrderBookLevelsInfo& levelsInfo) -> void;
+
+    [[nodiscard]] auto value() const -> std::uint64_t { return m_value; }
+
+private:
+    static constexpr std::uint64_t s_offsetBasis { 0xcbf29ce484222325 };
+    static constexpr std::uint64_t s_prime { 0x100000001b3 };
+
+    std::uint64_t m_value { s_offsetBasis };
+};
+
+// Books with a manual trade clock have it advanced to the event's timestamp first.
+[[nodiscard]] auto applyEvent(OrderBook& orderBook, const Event& event) -> Trades;
+auto digestBook(Digest& digest, InstrumentId instrument, const OrderBook& orderBook) -> void;
+
+// Routes events to one order book per instrument, creating books as new instruments appear. Books are confined to
+// the replaying thread, so they take no locks and day orders never expire part way through a replay, and trades are
+// timestamped with capture time.
+class Replayer {
+public:
+    explicit Replayer(const OrderBookOptions& options = {}) // The threading model and trade clock are always overridden.
+        : m_options { options }
+    {
+        m_options.threadingModel = ThreadingModel::confined;
+        m_options.tradeClock = TradeClock::manual;
+    }
+
+    [[nodiscard]] auto apply(const Event& event) -> Trades;
+    [[nodiscard]] auto bookCount() const -> std::size_t { return m_books.size(); }
+    [[nodiscard]] auto bookDigest() const -> std::uint64_t; // Covers every book in instrument order.
+
+private:
+    OrderBookOptions m_options;
+    std::map<InstrumentId, std::unique_ptr<OrderBook>> m_books;
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+enum class SpinPolicy {
+    pause, // Spin with a CPU pause hint. Lowest latency, but needs a core to itself.
+    yield, // Yield to the scheduler between polls.
+    backoff, // Pause for exponentially longer between polls, then fall back to yielding.
+};
+
+// Waits between polls of a busy-wait loop according to a spin policy.
+class Spinner {
+public:
+    explicit Spinner(SpinPolicy policy)
+        : m_policy { policy }
+    {
+    }
+
+    auto spin() -> void;
+    auto reset() -> void { m_spins = 0; }
+
+private:
+    SpinPolicy m_policy;
+    std::uint32_t m_spins { 0 };
+};
+
+// A unit of work handed to another thread, which sets done once it has been run.
+struct Request {
+    void (*invoke)(void* context) {};
+    void* context {};
+    std::atomic<bool> done { false };
+};
+
+// Bounded queue of requests with any number of producers and a single consumer. Never allocates after construction.
+class RequestQueue {
+public:
+    explicit RequestQueue(std::size_t capacity); // Rounded up to a power of two.
+
+    [[nodiscard]] auto tryPush(Request* request) -> bool; // Fails if the queue is full.
+    [[nodiscard]] auto tryPop() -> Request*; // Returns nullptr if the queue is empty. Consumer only.
+
+private:
+    struct alignas(Constants::cacheLineSize) Cell {
+        std::atomic<std::size_t> sequence;
+        Request* request;
+    };
+
+    std::vector<Cell> m_cells;
+    std::size_t m_mask;
+    alignas(Constants::cacheLineSize) std::atomic<std::size_t> m_tail { 0 };
+    alignas(Constants::cacheLineSize) std::size_t m_head { 0 };
+};
+
+// Best effort: returns false if the core does not exist or thread affinity is unsupported. A negative core is a no-op.
+auto pinThread(std::thread& thread, int core) -> bool;
@@ -0,0 +1,54 @@
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed-size pool where each worker has its own task queue. Workers take their newest task first, and steal the
+// oldest task from another worker when their own queue is empty.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t threads);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    auto operator=(ThreadPool&&) -> ThreadPool& = delete;
+
+    // Tasks submitted from a worker go to that worker's queue, others are spread across the queues. Tasks must not throw.
+    auto submit(Task task) -> void;
+    auto wait() -> void; // Blocks until every submitted task, including any they submit, has finished.
+
+    [[nodiscard]] auto size() const -> std::size_t { return m_threads.size(); }
+
+private:
+    struct alignas(Constants::cacheLineSize) Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<std::size_t> m_nextQueue { 0 };
+
+    std::atomic<std::size_t> m_queued { 0 }; // Tasks waiting in any queue.
+    std::atomic<std::size_t> m_unfinished { 0 }; // Tasks submitted but not yet finished.
+
+    // Only used to put idle workers, and callers of wait(), to sleep.
+    std::mutex m_mutex;
+    std::condition_variable m_workAvailable;
+    std::condition_variable m_allDone;
+    bool m_stop { false }; // Guarded by m_mutex.
+
+    auto work(std::size_t index) -> void;
+    [[nodiscard]] auto take(std::size_t index) -> Task; // Returns an empty task if every queue is empty.
+};
@@ -0,0 +1,79 @@
+#pragma once
+#include "common.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Bar {
+    Timestamp start {}; // Start of the interval, or of the first trade for a session bar.
+    Price open {};
+    Price high {};
+    Price low {};
+    Price close {};
+    std::uint64_t volume {};
+    std::uint64_t notional {}; // Sum of price * quantity, used for the VWAP.
+    std::uint64_t tradeCount {};
+
+    [[nodiscard]] auto vwap() const -> double
+    {
+        return volume == 0 ? 0.0 : static_cast<double>(notional) / static_cast<double>(volume);
+    }
+};
+
+using Bars = std::vector<Bar>;
+using BarIntervals = std::vector<std::chrono::nanoseconds>;
+
+// Rolling trade statistics, updated incrementally by a single writer and readable from any thread without locking.
+// Updates are published through a sequence lock, so readers retry rather than block if they overlap a write.
+class TradeStats {
+public:
+    TradeStats(const BarIntervals& intervals, std::size_t history); // Throws std::invalid_argument unless every interval is positive.
+
+    TradeStats(const TradeStats&) = delete;
+    auto operator=(const TradeStats&) -> TradeStats& = delete;
+    TradeStats(TradeStats&&) = delete;
+    auto operator=(TradeStats&&) -> TradeStats& = delete;
+    ~TradeStats() = default;
+
+    // Should only be called by the writer. Allocation-free.
+    auto record(Price price, Quantity quantity, Timestamp timestamp) -> void;
+
+    [[nodiscard]] auto intervals() const -> std::span<const std::chrono::nanoseconds> { return m_lengths; }
+    [[nodiscard]] auto lastPrice() const -> Price; // Constants::invalidPrice until the first trade.
+    [[nodiscard]] auto session() const -> Bar;
+    [[nodiscard]] auto bars(std::size_t interval) const -> Bars; // Oldest first, ending with the current interval.
+
+private:
+    struct AtomicBar {
+        std::atomic<Timestamp> start;
+        std::atomic<Price> open;
+        std::atomic<Price> high;
+        std::atomic<Price> low;
+        std::atomic<Price> close;
+        std::atomic<std::uint64_t> volume;
+        std::atomic<std::uint64_t> notional;
+        std::atomic<std::uint64_t> tradeCount;
+
+        [[nodiscard]] auto load() const -> Bar;
+        auto store(const Bar& bar) -> void;
+    };
+
+    struct Interval {
+        Bar current; // The writer's copy of the newest bar.
+        std::atomic<std::uint64_t> barCount;
+        std::vector<AtomicBar> ring;
+    };
+
+    std::vector<std::chrono::nanoseconds> m_lengths;
+    std::vector<Interval> m_intervals;
+    Bar m_session;
+    AtomicBar m_publishedSession;
+    std::atomic<Price> m_lastPrice;
+    std::atomic<std::uint64_t> m_sequence; // Odd while a write is in progress.
+
+    template <typename Read>
+    [[nodiscard]] auto readConsistent(Read read) const -> decltype(read());
+};
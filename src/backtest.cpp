@@ -0,0 +1,97 @@
+#include "backtest.hpp"
+#include "replay.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <map>
+#include <memory>
+
+namespace {
+struct BookTask {
+    const InstrumentStream* stream;
+    std::unique_ptr<OrderBook> orderBook;
+    std::size_t next { 0 };
+    Trades trades {};
+};
+
+// Applies the next batch of a stream, then resubmits itself so that a long stream can move between workers.
+auto runBatch(ThreadPool& pool, BookTask& task, std::size_t batchSize) -> void
+{
+    const auto& events { task.stream->events };
+    const auto end { std::min(task.next + batchSize, events.size()) };
+
+    for (; task.next < end; ++task.next) {
+        const auto trades { applyEvent(*task.orderBook, events[task.next]) };
+        task.trades.insert(task.trades.end(), trades.begin(), trades.end());
+    }
+
+    if (task.next < events.size()) {
+        pool.submit([&pool, &task, batchSize] { runBatch(pool, task, batchSize); });
+    }
+}
+} // namespace
+
+auto splitByInstrument(std::span<const Event> events) -> InstrumentStreams
+{
+    std::map<InstrumentId, Events> grouped;
+    for (const auto& event : events) {
+        grouped[event.instrument].emplace_back(event);
+    }
+
+    InstrumentStreams streams;
+    streams.reserve(grouped.size());
+    for (auto& [instrument, instrumentEvents] : grouped) {
+        streams.push_back({ instrument, std::move(instrumentEvents) });
+    }
+    return streams;
+}
+
+auto runBacktest(std::span<const InstrumentStream> streams, const BacktestOptions& options) -> BacktestResult
+{
+    auto bookOptions { options.bookOptions };
+    bookOptions.threadingModel = ThreadingModel::confined;
+    bookOptions.tradeClock = TradeClock::manual;
+    const auto batchSize { std::max(options.batchSize, std::size_t { 1 }) };
+
+    // Fully populated before any task starts, so the tasks' references stay valid.
+    std::vector<BookTask> tasks;
+    tasks.reserve(streams.size());
+    for (const auto& stream : streams) {
+        tasks.push_back({ .stream = &stream, .orderBook = std::make_unique<OrderBook>(bookOptions), .next = 0, .trades = {} });
+    }
+
+    {
+        ThreadPool pool { options.threads };
+        for (auto& task : tasks) {
+            pool.submit([&pool, &task, batchSize] { runBatch(pool, task, batchSize); });
+        }
+        pool.wait();
+    }
+
+    BacktestResult result;
+    result.books.reserve(tasks.size());
+    Digest bookDigest;
+    Digest tradeDigest;
+
+    for (auto& task : tasks) {
+        const auto& orderBook { *task.orderBook };
+        digestBook(bookDigest, task.stream->instrument, orderBook);
+        for (const auto& trade : task.trades) {
+            tradeDigest.add(trade);
+        }
+
+        auto& book { result.books.emplace_back() };
+        book.instrument = task.stream->instrument;
+        book.eventCount = task.stream->events.size();
+        book.restingOrders = orderBook.size();
+        book.session = orderBook.tradeStats().session();
+        book.trades = std::move(task.trades);
+
+        result.eventCount += book.eventCount;
+        result.tradeCount += book.trades.size();
+        result.volume += book.session.volume;
+    }
+
+    result.bookDigest = bookDigest.value();
+    result.tradeDigest = tradeDigest.value();
+    return result;
+}
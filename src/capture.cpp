@@ -0,0 +1,220 @@
+#include "capture.hpp"
+#include "order.hpp"
+#include <charconv>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+auto splitFields(std::string_view line) -> std::vector<std::string_view>
+{
+    std::vector<std::string_view> fields;
+    while (true) {
+        const auto comma { line.find(',') };
+        fields.emplace_back(line.substr(0, comma));
+        if (comma == std::string_view::npos) {
+            return fields;
+        }
+        line.remove_prefix(comma + 1);
+    }
+}
+
+template <typename T>
+auto parseNumber(std::string_view field, std::size_t lineNumber) -> T
+{
+    T value {};
+    if (field.empty()) {
+        return value;
+    }
+    const auto [end, error] { std::from_chars(field.data(), field.data() + field.size(), value) };
+    if (error != std::errc {} || end != field.data() + field.size()) {
+        throw std::runtime_error { "Invalid number on line " + std::to_string(lineNumber) };
+    }
+    return value;
+}
+
+auto parseKind(std::string_view field, std::size_t lineNumber) -> EventKind
+{
+    if (field == "place") {
+        return EventKind::place;
+    }
+    if (field == "cancel") {
+        return EventKind::cancel;
+    }
+    if (field == "modify") {
+        return EventKind::modify;
+    }
+    throw std::runtime_error { "Invalid action on line " + std::to_string(lineNumber) };
+}
+
+auto parseType(std::string_view field, std::size_t lineNumber) -> OrderType
+{
+    if (field == "day") {
+        return OrderType::day;
+    }
+    if (field == "fok") {
+        return OrderType::fok;
+    }
+    if (field == "gtc" || field.empty()) {
+        return OrderType::gtc;
+    }
+    if (field == "ioc") {
+        return OrderType::ioc;
+    }
+    if (field == "market") {
+        return OrderType::market;
+    }
+    throw std::runtime_error { "Invalid order type on line " + std::to_string(lineNumber) };
+}
+
+auto parseSide(std::string_view field, std::size_t lineNumber) -> Side
+{
+    if (field == "buy" || field.empty()) {
+        return Side::buy;
+    }
+    if (field == "sell") {
+        return Side::sell;
+    }
+    throw std::runtime_error { "Invalid side on line " + std::to_string(lineNumber) };
+}
+
+// Guards against corrupt records, whose enums would otherwise be cast to values that do not exist.
+auto isValid(const Event& event) -> bool
+{
+    return event.kind <= EventKind::modify && event.orderType() <= OrderType::market && event.orderSide() <= Side::sell;
+}
+} // namespace
+
+Capture::Capture(const std::filesystem::path& path)
+{
+    const auto fd { ::open(path.c_str(), O_RDONLY) }; // NOLINT(cppcoreguidelines-pro-type-vararg)
+    if (fd < 0) {
+        throw std::runtime_error { "Unable to open capture " + path.string() };
+    }
+
+    struct stat status { };
+    if (::fstat(fd, &status) != 0 || static_cast<std::size_t>(status.st_size) < sizeof(CaptureHeader)) {
+        ::close(fd);
+        throw std::runtime_error { "Capture is too small to contain a header: " + path.string() };
+    }
+
+    m_mappingSize = static_cast<std::size_t>(status.st_size);
+    m_mapping = ::mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (m_mapping == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        throw std::runtime_error { "Unable to map capture " + path.string() };
+    }
+
+    CaptureHeader header;
+    std::memcpy(&header, m_mapping, sizeof(header));
+
+    const auto available { (m_mappingSize - sizeof(CaptureHeader)) / sizeof(Event) };
+    if (header.magic != Constants::captureMagic || header.version != Constants::captureVersion
+        || header.eventSize != sizeof(Event) || header.eventCount > available) {
+        ::munmap(m_mapping, m_mappingSize);
+        throw std::runtime_error { "Invalid capture header: " + path.string() };
+    }
+
+    // The header is the same size as an event, so the events that follow it are suitably aligned.
+    const auto* first { static_cast<const Event*>(m_mapping) + 1 }; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    m_events = { first, header.eventCount };
+    for (std::size_t i { 0 }; i < m_events.size(); ++i) {
+        if (!isValid(m_events[i])) {
+            ::munmap(m_mapping, m_mappingSize);
+            throw std::runtime_error { "Invalid event " + std::to_string(i) + " in capture " + path.string() };
+        }
+    }
+    ::madvise(m_mapping, m_mappingSize, MADV_SEQUENTIAL);
+}
+
+Capture::~Capture()
+{
+    ::munmap(m_mapping, m_mappingSize);
+}
+
+auto parseCsv(std::istream& input) -> Events
+{
+    Events events;
+    std::string line;
+    std::size_t lineNumber { 0 };
+
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        const auto fields { splitFields(line) };
+        if (lineNumber == 1 && fields[0] == "timestamp") {
+            continue;
+        }
+        if (fields.size() < 4 || fields.size() > 8) {
+            throw std::runtime_error { "Wrong number of fields on line " + std::to_string(lineNumber) };
+        }
+
+        auto field = [&fields](std::size_t index) { return index < fields.size() ? fields[index] : std::string_view {}; };
+        auto require = [&field, lineNumber](std::size_t index, const char* name) {
+            if (field(index).empty()) {
+                throw std::runtime_error { std::string { "Missing " } + name + " on line " + std::to_string(lineNumber) };
+            }
+        };
+
+        Event event;
+        event.timestamp = parseNumber<Timestamp>(field(0), lineNumber);
+        event.instrument = parseNumber<InstrumentId>(field(1), lineNumber);
+        event.kind = parseKind(field(2), lineNumber);
+        event.id = parseNumber<OrderId>(field(3), lineNumber);
+        event.type = static_cast<std::uint8_t>(parseType(field(4), lineNumber));
+        event.side = static_cast<std::uint8_t>(parseSide(field(5), lineNumber));
+        event.price = parseNumber<Price>(field(6), lineNumber);
+        event.quantity = parseNumber<Quantity>(field(7), lineNumber);
+
+        if (event.kind == EventKind::place) {
+            require(5, "side");
+            if (event.orderType() != OrderType::market) {
+                require(6, "price");
+            }
+        }
+        if (event.kind != EventKind::cancel) {
+            require(7, "quantity");
+            if (event.kind == EventKind::modify) {
+                require(6, "price");
+            }
+        }
+        events.emplace_back(event);
+    }
+    return events;
+}
+
+auto writeCapture(const std::filesystem::path& path, std::span<const Event> events) -> void
+{
+    std::ofstream output { path, std::ios::binary | std::ios::trunc };
+    if (!output) {
+        throw std::runtime_error { "Unable to create capture " + path.string() };
+    }
+
+    const CaptureHeader header {
+        .magic = Constants::captureMagic,
+        .version = Constants::captureVersion,
+        .eventSize = sizeof(Event),
+        .eventCount = events.size(),
+    };
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    output.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size_bytes()));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+    if (!output) {
+        throw std::runtime_error { "Unable to write capture " + path.string() };
+    }
+}
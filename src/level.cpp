@@ -0,0 +1,171 @@
+#include "level.hpp"
+#include "order.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <utility>
+
+auto Level::append(const OrderPtr& order) -> Ticket
+{
+    assert(!ticketsExhausted());
+    const auto ticket { m_nextTicket++ };
+
+    m_orders.push_back({
+        .id = order->id(),
+        .remainingQuantity = order->remainingQuantity(),
+        .price = order->price(),
+        .ticket = ticket,
+        .side = static_cast<std::uint32_t>(order->side()),
+        .type = static_cast<std::uint32_t>(order->type()),
+        .dead = 0,
+    });
+    m_owners.emplace_back(order);
+    m_quantity += order->remainingQuantity();
+    return ticket;
+}
+
+auto Level::erase(Ticket ticket) -> void
+{
+    const auto index { indexOf(ticket) };
+    m_quantity -= m_orders[index].remainingQuantity;
+
+    if (index == m_head) {
+        popFront();
+        return;
+    }
+
+    const auto offset { static_cast<std::ptrdiff_t>(index) };
+    m_orders.erase(std::next(m_orders.begin(), offset));
+    m_owners.erase(std::next(m_owners.begin(), offset));
+}
+
+auto Level::kill(Ticket ticket) -> void
+{
+    const auto index { indexOf(ticket) };
+    auto& order { m_orders[index] };
+    m_quantity -= order.remainingQuantity;
+
+    if (index == m_head) {
+        popFront();
+        return;
+    }
+
+    order.remainingQuantity = 0;
+    order.dead = 1;
+    m_owners[index].reset();
+    ++m_tombstones;
+}
+
+auto Level::find(Ticket ticket) const -> const HotOrder&
+{
+    return m_orders[indexOf(ticket)];
+}
+
+auto Level::fillFront(Quantity quantity) -> void
+{
+    auto& order { m_orders[m_head] };
+    assert(quantity <= order.remainingQuantity);
+    order.remainingQuantity -= quantity;
+    m_quantity -= quantity;
+}
+
+auto Level::popFront() -> void
+{
+    assert(!empty());
+    syncOwner(m_head);
+    m_owners[m_head].reset();
+    ++m_head;
+
+    // Keep the front live so that matching never sees a tombstone.
+    while (m_head < m_orders.size() && m_orders[m_head].dead != 0) {
+        ++m_head;
+        --m_tombstones;
+    }
+    compactFront();
+}
+
+auto Level::syncFront() -> void
+{
+    if (!empty()) {
+        syncOwner(m_head);
+    }
+}
+
+auto Level::shouldCompact(double tombstoneRatio) const -> bool
+{
+    return m_tombstones >= Constants::minLevelCompaction
+        && static_cast<double>(m_tombstones) > tombstoneRatio * static_cast<double>(m_orders.size() - m_head);
+}
+
+// Removes consumed orders and tombstones in one pass, preserving the ticket order of the live ones.
+auto Level::compact() -> void
+{
+    std::size_t live { 0 };
+    for (auto i { static_cast<std::size_t>(m_head) }; i < m_orders.size(); ++i) {
+        if (m_orders[i].dead == 0) {
+            m_orders[live] = m_orders[i];
+            m_owners[live] = std::move(m_owners[i]);
+            ++live;
+        }
+    }
+    m_orders.resize(live);
+    m_owners.resize(live);
+    m_head = 0;
+    m_tombstones = 0;
+}
+
+auto Level::renumber() -> void
+{
+    compact();
+
+    m_nextTicket = 0;
+    for (auto& order : m_orders) {
+        order.ticket = m_nextTicket++;
+    }
+}
+
+auto Level::indexOf(Ticket ticket) const -> std::size_t
+{
+    // Tickets are contiguous until an order is erased from the middle of the level, so try a direct lookup first.
+    const auto guess { static_cast<std::size_t>(ticket - m_orders.front().ticket) };
+    if (guess < m_orders.size() && m_orders[guess].ticket == ticket) {
+        return guess;
+    }
+
+    const auto begin { std::next(m_orders.begin(), static_cast<std::ptrdiff_t>(m_head)) };
+    const auto it { std::lower_bound(begin, m_orders.end(), ticket,
+        [](const HotOrder& order, Ticket value) { return order.ticket < value; }) };
+    assert(it != m_orders.end() && it->ticket == ticket);
+    return static_cast<std::size_t>(std::distance(m_orders.begin(), it));
+}
+
+auto Level::syncOwner(std::size_t index) -> void
+{
+    auto& owner { *m_owners[index] };
+    const auto filled { owner.remainingQuantity() - m_orders[index].remainingQuantity };
+    if (filled != 0) {
+        owner.fill(filled);
+    }
+}
+
+// Filled orders are dropped from the front in batches, so popping stays O(1) without a ring buffer.
+auto Level::compactFront() -> void
+{
+    if (empty()) {
+        m_orders.clear();
+        m_owners.clear();
+        m_head = 0;
+        return;
+    }
+    if (m_head >= Constants::minLevelCompaction && m_head * 2 >= m_orders.size()) {
+        dropConsumed();
+    }
+}
+
+auto Level::dropConsumed() -> void
+{
+    const auto head { static_cast<std::ptrdiff_t>(m_head) };
+    m_orders.erase(m_orders.begin(), std::next(m_orders.begin(), head));
+    m_owners.erase(m_owners.begin(), std::next(m_owners.begin(), head));
+    m_head = 0;
+}
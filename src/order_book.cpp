@@ -1,59 +1,84 @@
 #include "order.hpp"
 #include "trade.hpp"
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <order_book.hpp>
 
-OrderBook::OrderBook()
-    : m_shutdown { false }
-    , m_temporalThread { &OrderBook::cancelExpiredDayOrders, this }
+OrderBook::OrderBook(const OrderBookOptions& options)
+    : m_bids { LevelAllocator { &m_bidMemory } }
+    , m_asks { LevelAllocator { &m_askMemory } }
+    , m_orders { EntryAllocator { &m_indexMemory } }
+    , m_options { options }
+    , m_tradeStats { options.barIntervals, options.barHistory }
+    , m_shutdown { false }
+    , m_requests { options.threadingModel == ThreadingModel::busyPoll ? options.requestQueueCapacity : 0 }
 {
+    // Pinning is best effort, as a missing or unavailable core should not stop the book from working.
+    if (m_options.threadingModel == ThreadingModel::busyPoll) {
+        m_matchingThread = std::thread { &OrderBook::pollRequests, this };
+        pinThread(m_matchingThread, m_options.matchingCore);
+    }
+    if (m_options.threadingModel != ThreadingModel::confined) {
+        m_temporalThread = std::thread { &OrderBook::cancelExpiredDayOrders, this };
+        pinThread(m_temporalThread, m_options.housekeepingCore);
+    }
 }
 
 OrderBook::~OrderBook()
 {
-    m_shutdown.store(true, std::memory_order_release);
+    {
+        // Held so that the notification cannot be missed between the temporal thread's check and its wait.
+        std::lock_guard lock { m_mutex };
+        m_shutdown.store(true, std::memory_order_release);
+    }
     m_shutdownCond.notify_one();
     if (m_temporalThread.joinable()) {
         m_temporalThread.join();
     }
+
+    // Stopped last, as the temporal thread may have been waiting on a request.
+    m_stopMatching.store(true, std::memory_order_release);
+    if (m_matchingThread.joinable()) {
+        m_matchingThread.join();
+    }
 }
 
 auto OrderBook::cancelOrder(OrderId id) -> void
 {
-    std::lock_guard lock { m_mutex };
-    cancelOrderNoLock(id);
+    execute([this, id] { cancelOrderNoLock(id); });
 }
 
 auto OrderBook::levelsInfo() const -> OrderBookLevelsInfo
 {
-    std::lock_guard lock { m_mutex };
-    return levelsInfoNoLock();
+    return execute([this] { return levelsInfoNoLock(); });
+}
+
+auto OrderBook::memoryStats() const -> MemoryStats
+{
+    return execute([this] { return memoryStatsNoLock(); });
 }
 
 auto OrderBook::placeOrder(const OrderPtr& order) -> Trades
 {
-    std::lock_guard lock { m_mutex };
-    return placeOrderNoLock(order);
+    return execute([this, &order] { return placeOrderNoLock(order); });
+}
+
+auto OrderBook::setTime(Timestamp time) -> void
+{
+    if (m_options.tradeClock == TradeClock::manual) {
+        execute([this, time] { m_time = time; });
+    }
 }
 
 auto OrderBook::size() const -> std::size_t
 {
-    std::lock_guard lock { m_mutex };
-    return m_orders.size();
+    return execute([this] { return m_orders.size(); });
 }
 
 auto OrderBook::updateOrder(const OrderUpdate& update) -> Trades
 {
-    std::lock_guard lock { m_mutex };
-
-    if (!m_orders.contains(update.id())) {
-        return {};
-    }
-
-    const auto& existingOrder { m_orders[update.id()].order };
-    cancelOrderNoLock(update.id());
-    return placeOrderNoLock(update.toOrder(existingOrder->side(), existingOrder->type()));
+    return execute([this, &update] { return updateOrderNoLock(update); });
 }
 
 auto OrderBook::cancelExpiredDayOrders() -> void
@@ -77,49 +102,79 @@ auto OrderBook::cancelExpiredDayOrders() -> void
             }
         }
 
-        std::vector<OrderId> expiredOrders;
-        {
-            std::lock_guard lock { m_mutex };
-            for (const auto& [id, entry] : m_orders) {
-                if (entry.order->type() == OrderType::day) {
-                    expiredOrders.emplace_back(id);
-                }
-            }
+        execute([this] { cancelDayOrdersNoLock(); });
+    }
+}
+
+auto OrderBook::pollRequests() -> void
+{
+    Spinner spinner { m_options.spinPolicy };
+
+    while (true) {
+        if (auto* request { m_requests.tryPop() }) {
+            request->invoke(request->context);
+            request->done.store(true, std::memory_order_release);
+            spinner.reset();
+            continue;
+        }
+        // Only checked once the queue is empty, so that every submitted request completes.
+        if (m_stopMatching.load(std::memory_order_acquire)) {
+            return;
         }
-        cancelOrders(expiredOrders);
+        spinner.spin();
     }
 }
 
-auto OrderBook::cancelOrders(const OrderIds& ids) -> void
+auto OrderBook::cancelDayOrdersNoLock() -> void
 {
-    std::lock_guard lock { m_mutex };
-    for (const auto id : ids) {
+    std::vector<OrderId> expiredOrders;
+    auto collectDayOrders = [&expiredOrders](const Level& level) {
+        for (const auto& order : level.orders()) {
+            if (order.orderType() == OrderType::day && order.dead == 0) {
+                expiredOrders.emplace_back(order.id);
+            }
+        }
+    };
+    for (const auto& [price, level] : m_bids) {
+        collectDayOrders(level);
+    }
+    for (const auto& [price, level] : m_asks) {
+        collectDayOrders(level);
+    }
+
+    for (const auto id : expiredOrders) {
         cancelOrderNoLock(id);
     }
 }
 
 auto OrderBook::cancelOrderNoLock(OrderId id) -> void
 {
-    if (!m_orders.contains(id)) {
+    const auto it { m_orders.find(id) };
+    if (it == m_orders.end()) {
         return;
     }
 
-    const auto& [order, it] { m_orders[id] };
+    const auto [price, side, ticket] { it->second };
+    m_orders.erase(it);
 
-    if (order->side() == Side::buy) {
-        auto& buyOrders { m_bids[order->price()] };
-        buyOrders.erase(it);
-        if (buyOrders.empty()) {
-            m_bids.erase(order->price());
+    auto& level { levelNoLock(side, price) };
+    if (m_options.cancelMode == CancelMode::lazy) {
+        level.kill(ticket);
+        // Renumbered rather than just compacted, so that tickets stay contiguous for the direct lookup in the level.
+        if (level.shouldCompact(m_options.tombstoneRatio)) {
+            renumberLevelNoLock(level);
         }
     } else {
-        auto& sellOrders { m_asks[order->price()] };
-        sellOrders.erase(it);
-        if (sellOrders.empty()) {
-            m_asks.erase(order->price());
+        level.erase(ticket);
+    }
+    if (level.empty()) {
+        m_levelArrayMemory.deallocate(level.allocatedBytes());
+        if (side == Side::buy) {
+            m_bids.erase(price);
+        } else {
+            m_asks.erase(price);
         }
     }
-    m_orders.erase(id);
 }
 
 auto OrderBook::canFullyFillOrderNoLock(Side side, Price price, Quantity quantity) const -> bool
@@ -171,6 +226,11 @@ auto OrderBook::convertMarketOrderNoLock(const OrderPtr& order) -> bool
     return false;
 }
 
+auto OrderBook::levelNoLock(Side side, Price price) -> Level&
+{
+    return side == Side::buy ? m_bids.find(price)->second : m_asks.find(price)->second;
+}
+
 auto OrderBook::levelsInfoNoLock() const -> OrderBookLevelsInfo
 {
     LevelsInfo bidsInfo;
@@ -180,30 +240,41 @@ auto OrderBook::levelsInfoNoLock() const -> OrderBookLevelsInfo
     bidsInfo.reserve(m_bids.size());
     asksInfo.reserve(m_asks.size());
 
-    auto createLevelInfo = [](Price price, const Orders& orders) {
-        Quantity totalQuantity { 0 };
-
-        for (const auto& order : orders) {
-            totalQuantity += order->remainingQuantity();
-        }
-
-        return LevelInfo { price, totalQuantity };
-    };
-
-    for (const auto& [price, orders] : m_bids) {
-        bidsInfo.emplace_back(createLevelInfo(price, orders));
+    for (const auto& [price, level] : m_bids) {
+        bidsInfo.emplace_back(price, level.quantity());
     }
 
-    for (const auto& [price, orders] : m_asks) {
-        asksInfo.emplace_back(createLevelInfo(price, orders));
+    for (const auto& [price, level] : m_asks) {
+        asksInfo.emplace_back(price, level.quantity());
     }
 
     return OrderBookLevelsInfo { bidsInfo, asksInfo };
 }
 
-auto OrderBook::matchOrdersNoLock() -> Trades
+auto OrderBook::memoryStatsNoLock() const -> MemoryStats
+{
+    // Bucket arrays are allocated through the index's allocator too, so are already included in its usage.
+    return {
+        .liveOrders = m_orders.size(),
+        .peakLiveOrders = m_peakOrders,
+        .bidLevels = m_bids.size(),
+        .askLevels = m_asks.size(),
+        .peakLevels = m_peakLevels,
+        .bidLevelNodes = { m_bidMemory.bytes(), m_bidMemory.peakBytes() },
+        .askLevelNodes = { m_askMemory.bytes(), m_askMemory.peakBytes() },
+        .levelArrays = { m_levelArrayMemory.bytes(), m_levelArrayMemory.peakBytes() },
+        .orderIndex = { m_indexMemory.bytes(), m_indexMemory.peakBytes() },
+        .indexBuckets = m_orders.bucket_count(),
+        .indexLoadFactor = m_orders.load_factor(),
+        .peakBookBytes = m_bookMemory.peakBytes(),
+        .callerOrderBytes = m_orders.size() * Constants::sharedOrderBytes,
+    };
+}
+
+auto OrderBook::matchOrdersNoLock(Side aggressor) -> Trades
 {
     Trades trades;
+    Timestamp now { 0 }; // Only read from the clock once a trade occurs.
     trades.reserve(std::min(m_bids.size(), m_asks.size())); // Ensures no further reallocations.
 
     while (true) {
@@ -211,43 +282,58 @@ auto OrderBook::matchOrdersNoLock() -> Trades
             break;
         }
 
-        auto& [bestBidPrice, buyOrders] { *m_bids.begin() };
-        auto& [bestAskPrice, sellOrders] { *m_asks.begin() };
+        const auto bestBid { m_bids.begin() };
+        const auto bestAsk { m_asks.begin() };
+        auto& [bestBidPrice, buyOrders] { *bestBid };
+        auto& [bestAskPrice, sellOrders] { *bestAsk };
 
         if (bestBidPrice < bestAskPrice) {
             break;
         }
 
         while (!buyOrders.empty() && !sellOrders.empty()) {
-            auto& earliestBuyOrder { buyOrders.front() };
-            auto& earliestSellOrder { sellOrders.front() };
+            const auto& earliestBuyOrder { buyOrders.front() };
+            const auto& earliestSellOrder { sellOrders.front() };
+            const auto buyId { earliestBuyOrder.id };
+            const auto sellId { earliestSellOrder.id };
 
-            auto tradeQuantity { std::min(earliestBuyOrder->remainingQuantity(), earliestSellOrder->remainingQuantity()) };
+            auto tradeQuantity { std::min(earliestBuyOrder.remainingQuantity, earliestSellOrder.remainingQuantity) };
 
             trades.emplace_back(
                 tradeQuantity,
-                TradeSideInfo { earliestBuyOrder->id(), bestBidPrice },
-                TradeSideInfo { earliestSellOrder->id(), bestAskPrice });
-
-            earliestBuyOrder->fill(tradeQuantity);
-            earliestSellOrder->fill(tradeQuantity);
+                TradeSideInfo { buyId, bestBidPrice },
+                TradeSideInfo { sellId, bestAskPrice });
 
-            if (earliestBuyOrder->isFilled()) {
-                m_orders.erase(earliestBuyOrder->id());
-                buyOrders.pop_front();
-            }
-            if (earliestSellOrder->isFilled()) {
-                m_orders.erase(earliestSellOrder->id());
-                sellOrders.pop_front();
+            // Trades execute at the resting order's price.
+            if (now == 0) {
+                now = tradeTimeNoLock();
             }
+            m_tradeStats.record(aggressor == Side::buy ? bestAskPrice : bestBidPrice, tradeQuantity, now);
+
+            buyOrders.fillFront(tradeQuantity);
+            sellOrders.fillFront(tradeQuantity);
 
-            if (buyOrders.empty()) {
-                m_bids.erase(bestBidPrice);
+            // Popping may compact the level, so only the copied ids are used from here on.
+            if (earliestBuyOrder.remainingQuantity == 0) {
+                m_orders.erase(buyId);
+                buyOrders.popFront();
             }
-            if (sellOrders.empty()) {
-                m_asks.erase(bestAskPrice);
+            if (earliestSellOrder.remainingQuantity == 0) {
+                m_orders.erase(sellId);
+                sellOrders.popFront();
             }
         }
+        buyOrders.syncFront();
+        sellOrders.syncFront();
+
+        if (buyOrders.empty()) {
+            m_levelArrayMemory.deallocate(buyOrders.allocatedBytes());
+            m_bids.erase(bestBid);
+        }
+        if (sellOrders.empty()) {
+            m_levelArrayMemory.deallocate(sellOrders.allocatedBytes());
+            m_asks.erase(bestAsk);
+        }
     }
     return trades;
 }
@@ -256,7 +342,8 @@ auto OrderBook::placeOrderNoLock(const OrderPtr& order) -> Trades
 {
     Trades trades;
 
-    if (m_orders.contains(order->id())) {
+    // A resting order with nothing left could never be matched or removed by the matching loop.
+    if (m_orders.contains(order->id()) || order->remainingQuantity() == 0) {
         return trades;
     }
     if (order->type() == OrderType::market && !convertMarketOrderNoLock(order)) {
@@ -269,21 +356,18 @@ auto OrderBook::placeOrderNoLock(const OrderPtr& order) -> Trades
         return trades;
     }
 
-    Orders::iterator it;
-
-    if (order->side() == Side::buy) {
-        auto& buyOrders { m_bids[order->price()] };
-        buyOrders.emplace_back(order);
-        it = --buyOrders.end();
-    } else {
-        auto& sellOrders { m_asks[order->price()] };
-        sellOrders.emplace_back(order);
-        it = --sellOrders.end();
+    auto& level { order->side() == Side::buy ? m_bids[order->price()] : m_asks[order->price()] };
+    if (level.ticketsExhausted()) {
+        renumberLevelNoLock(level);
     }
 
-    m_orders.emplace(order->id(), OrderEntry { order, it });
+    const auto allocatedBytes { level.allocatedBytes() };
+    m_orders.emplace(order->id(), OrderEntry { order->price(), order->side(), level.append(order) });
+    m_levelArrayMemory.allocate(level.allocatedBytes() - allocatedBytes);
+    m_peakOrders = std::max(m_peakOrders, m_orders.size());
+    m_peakLevels = std::max(m_peakLevels, m_bids.size() + m_asks.size());
 
-    trades = matchOrdersNoLock();
+    trades = matchOrdersNoLock(order->side());
 
     if (order->type() == OrderType::ioc && !order->isFilled()) {
         cancelOrderNoLock(order->id());
@@ -291,3 +375,37 @@ auto OrderBook::placeOrderNoLock(const OrderPtr& order) -> Trades
 
     return trades;
 }
+
+auto OrderBook::renumberLevelNoLock(Level& level) -> void
+{
+    level.renumber();
+    for (const auto& order : level.orders()) {
+        m_orders.find(order.id)->second.ticket = order.ticket;
+    }
+}
+
+auto OrderBook::tradeTimeNoLock() const -> Timestamp
+{
+    using namespace std::chrono; // NOLINT(google-build-using-namespace)
+
+    if (m_options.tradeClock == TradeClock::manual) {
+        return m_time;
+    }
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+auto OrderBook::updateOrderNoLock(const OrderUpdate& update) -> Trades
+{
+    const auto it { m_orders.find(update.id()) };
+    if (it == m_orders.end()) {
+        return {};
+    }
+
+    const auto [price, side, ticket] { it->second }; // Copied because cancelling erases the entry.
+    const auto type { levelNoLock(side, price).find(ticket).orderType() };
+    cancelOrderNoLock(update.id());
+    if (update.quantity() == 0) {
+        return {}; // Reducing an order to nothing cancels it.
+    }
+    return placeOrderNoLock(update.toOrder(side, type));
+}
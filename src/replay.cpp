@@ -0,0 +1,79 @@
+#include "replay.hpp"
+#include "order.hpp"
+#include <memory>
+
+auto Digest::add(std::uint64_t value) -> void
+{
+    constexpr auto byteBits { 8U };
+    constexpr auto byteMask { 0xffU };
+
+    for (auto i { 0U }; i < sizeof(value); ++i) {
+        m_value ^= (value >> (i * byteBits)) & byteMask;
+        m_value *= s_prime;
+    }
+}
+
+auto Digest::add(const Trade& trade) -> void
+{
+    add(trade.quantity());
+    add(trade.buySideInfo().orderId);
+    add(trade.buySideInfo().price);
+    add(trade.sellSideInfo().orderId);
+    add(trade.sellSideInfo().price);
+}
+
+auto Digest::add(const OrderBookLevelsInfo& levelsInfo) -> void
+{
+    for (const auto* levels : { &levelsInfo.bidLevelsInfo(), &levelsInfo.askLevelsInfo() }) {
+        add(levels->size());
+        for (const auto& level : *levels) {
+            add(level.price);
+            add(level.quantity);
+        }
+    }
+}
+
+auto applyEvent(OrderBook& orderBook, const Event& event) -> Trades
+{
+    orderBook.setTime(event.timestamp);
+
+    switch (event.kind) {
+    case EventKind::place:
+        if (event.orderType() == OrderType::market) {
+            return orderBook.placeOrder(std::make_shared<Order>(event.id, event.orderSide(), event.quantity));
+        }
+        return orderBook.placeOrder(
+            std::make_shared<Order>(event.id, event.orderType(), event.orderSide(), event.price, event.quantity));
+    case EventKind::cancel:
+        orderBook.cancelOrder(event.id);
+        return {};
+    case EventKind::modify:
+        return orderBook.updateOrder({ event.id, event.price, event.quantity });
+    }
+    return {}; // Should be unreachable.
+}
+
+auto digestBook(Digest& digest, InstrumentId instrument, const OrderBook& orderBook) -> void
+{
+    digest.add(instrument);
+    digest.add(orderBook.size());
+    digest.add(orderBook.levelsInfo());
+}
+
+auto Replayer::apply(const Event& event) -> Trades
+{
+    auto& orderBook { m_books[event.instrument] };
+    if (!orderBook) {
+        orderBook = std::make_unique<OrderBook>(m_options);
+    }
+    return applyEvent(*orderBook, event);
+}
+
+auto Replayer::bookDigest() const -> std::uint64_t
+{
+    Digest digest;
+    for (const auto& [instrument, orderBook] : m_books) {
+        digestBook(digest, instrument, *orderBook);
+    }
+    return digest.value();
+}
@@ -0,0 +1,108 @@
+#include "runtime.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+constexpr std::uint32_t maxBackoffShift { 10 }; // Up to 1024 pauses between polls before yielding.
+
+auto cpuRelax() -> void
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield"); // NOLINT(hicpp-no-assembler)
+#endif
+}
+} // namespace
+
+auto Spinner::spin() -> void
+{
+    switch (m_policy) {
+    case SpinPolicy::pause:
+        cpuRelax();
+        return;
+    case SpinPolicy::yield:
+        std::this_thread::yield();
+        return;
+    case SpinPolicy::backoff:
+        if (m_spins > maxBackoffShift) {
+            std::this_thread::yield();
+            return;
+        }
+        for (auto i { 0U }; i < (1U << m_spins); ++i) {
+            cpuRelax();
+        }
+        ++m_spins;
+        return;
+    }
+}
+
+RequestQueue::RequestQueue(std::size_t capacity)
+    : m_cells(std::bit_ceil(std::max(capacity, std::size_t { 2 })))
+    , m_mask { m_cells.size() - 1 }
+{
+    for (std::size_t i { 0 }; i < m_cells.size(); ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+// Each cell's sequence says whose turn it is: producers may fill it when it equals their position, and the consumer
+// may empty it when it is one past its position.
+auto RequestQueue::tryPush(Request* request) -> bool
+{
+    auto position { m_tail.load(std::memory_order_relaxed) };
+
+    while (true) {
+        auto& cell { m_cells[position & m_mask] };
+        const auto sequence { cell.sequence.load(std::memory_order_acquire) };
+        const auto difference { static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position) };
+
+        if (difference == 0) {
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.request = request;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            return false;
+        } else {
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto RequestQueue::tryPop() -> Request*
+{
+    auto& cell { m_cells[m_head & m_mask] };
+    if (cell.sequence.load(std::memory_order_acquire) != m_head + 1) {
+        return nullptr;
+    }
+
+    auto* request { cell.request };
+    cell.sequence.store(m_head + m_cells.size(), std::memory_order_release);
+    ++m_head;
+    return request;
+}
+
+auto pinThread(std::thread& thread, int core) -> bool
+{
+    if (core < 0) {
+        return true;
+    }
+#ifdef __linux__
+    if (core >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(static_cast<std::size_t>(core), &cpus);
+    return ::pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,112 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Identifies the pool and queue owned by the current thread, if it is a worker.
+thread_local const ThreadPool* t_pool { nullptr };
+thread_local std::size_t t_queue { 0 };
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+    threads = std::max(threads, std::size_t { 1 });
+
+    m_queues.reserve(threads);
+    for (std::size_t i { 0 }; i < threads; ++i) {
+        m_queues.emplace_back(std::make_unique<Queue>());
+    }
+
+    m_threads.reserve(threads);
+    for (std::size_t i { 0 }; i < threads; ++i) {
+        m_threads.emplace_back(&ThreadPool::work, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+    {
+        std::lock_guard lock { m_mutex };
+        m_stop = true;
+    }
+    m_workAvailable.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+auto ThreadPool::submit(Task task) -> void
+{
+    const auto index { t_pool == this ? t_queue : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size() };
+
+    // Counted before the task is visible, so that a thief taking it cannot decrement either counter below zero.
+    m_unfinished.fetch_add(1);
+    m_queued.fetch_add(1);
+    {
+        auto& queue { *m_queues[index] };
+        std::lock_guard lock { queue.mutex };
+        queue.tasks.emplace_back(std::move(task));
+    }
+
+    // Taking the mutex orders this notification after any check made by a worker that is about to sleep.
+    {
+        std::lock_guard lock { m_mutex };
+    }
+    m_workAvailable.notify_one();
+}
+
+auto ThreadPool::wait() -> void
+{
+    std::unique_lock lock { m_mutex };
+    m_allDone.wait(lock, [this] { return m_unfinished.load() == 0; });
+}
+
+auto ThreadPool::work(std::size_t index) -> void
+{
+    t_pool = this;
+    t_queue = index;
+
+    while (true) {
+        if (auto task { take(index) }) {
+            task();
+            if (m_unfinished.fetch_sub(1) == 1) {
+                std::lock_guard lock { m_mutex };
+                m_allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock { m_mutex };
+        m_workAvailable.wait(lock, [this] { return m_queued.load() > 0 || m_stop; });
+        if (m_stop && m_queued.load() == 0) {
+            return;
+        }
+    }
+}
+
+auto ThreadPool::take(std::size_t index) -> Task
+{
+    Task task;
+
+    // The owner works from the back of its queue, so thieves taking from the front rarely contend with it.
+    for (std::size_t offset { 0 }; offset < m_queues.size() && !task; ++offset) {
+        auto& queue { *m_queues[(index + offset) % m_queues.size()] };
+        std::lock_guard lock { queue.mutex };
+        if (queue.tasks.empty()) {
+            continue;
+        }
+        if (offset == 0) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+
+    if (task) {
+        m_queued.fetch_sub(1);
+    }
+    return task;
+}
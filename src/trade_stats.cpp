@@ -0,0 +1,147 @@
+#include "trade_stats.hpp"
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+namespace {
+auto addTrade(Bar& bar, Price price, Quantity quantity) -> void
+{
+    bar.high = std::max(bar.high, price);
+    bar.low = std::min(bar.low, price);
+    bar.close = price;
+    bar.volume += quantity;
+    bar.notional += static_cast<std::uint64_t>(price) * quantity;
+    ++bar.tradeCount;
+}
+
+auto openBar(Timestamp start, Price price, Quantity quantity) -> Bar
+{
+    return {
+        .start = start,
+        .open = price,
+        .high = price,
+        .low = price,
+        .close = price,
+        .volume = quantity,
+        .notional = static_cast<std::uint64_t>(price) * quantity,
+        .tradeCount = 1,
+    };
+}
+} // namespace
+
+TradeStats::TradeStats(const BarIntervals& intervals, std::size_t history)
+    : m_lengths { intervals }
+    , m_intervals(intervals.size())
+    , m_lastPrice { Constants::invalidPrice }
+    , m_sequence { 0 }
+{
+    if (std::ranges::any_of(intervals, [](auto length) { return length <= std::chrono::nanoseconds::zero(); })) {
+        throw std::invalid_argument { "Bar intervals must be positive" };
+    }
+    for (auto& interval : m_intervals) {
+        interval.ring = std::vector<AtomicBar>(std::max(history, std::size_t { 1 }));
+    }
+}
+
+template <typename Read>
+auto TradeStats::readConsistent(Read read) const -> decltype(read())
+{
+    while (true) {
+        const auto before { m_sequence.load(std::memory_order_acquire) };
+        if (before % 2 != 0) {
+            continue;
+        }
+
+        auto result { read() };
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) == before) {
+            return result;
+        }
+    }
+}
+
+auto TradeStats::record(Price price, Quantity quantity, Timestamp timestamp) -> void
+{
+    const auto sequence { m_sequence.load(std::memory_order_relaxed) };
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (m_session.tradeCount == 0) {
+        m_session = openBar(timestamp, price, quantity);
+    } else {
+        addTrade(m_session, price, quantity);
+    }
+    m_publishedSession.store(m_session);
+    m_lastPrice.store(price, std::memory_order_relaxed);
+
+    for (std::size_t i { 0 }; i < m_intervals.size(); ++i) {
+        auto& interval { m_intervals[i] };
+        const auto length { static_cast<Timestamp>(m_lengths[i].count()) };
+        const auto start { timestamp - timestamp % length };
+
+        auto barCount { interval.barCount.load(std::memory_order_relaxed) };
+        if (barCount == 0 || start > interval.current.start) {
+            interval.current = openBar(start, price, quantity);
+            interval.barCount.store(++barCount, std::memory_order_relaxed);
+        } else {
+            addTrade(interval.current, price, quantity); // Out-of-order timestamps are folded into the current bar.
+        }
+        interval.ring[(barCount - 1) % interval.ring.size()].store(interval.current);
+    }
+
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+auto TradeStats::lastPrice() const -> Price
+{
+    return m_lastPrice.load(std::memory_order_relaxed);
+}
+
+auto TradeStats::session() const -> Bar
+{
+    return readConsistent([this] { return m_publishedSession.load(); });
+}
+
+auto TradeStats::bars(std::size_t interval) const -> Bars
+{
+    const auto& source { m_intervals.at(interval) };
+
+    return readConsistent([&source] {
+        const auto barCount { source.barCount.load(std::memory_order_relaxed) };
+        const auto available { std::min<std::uint64_t>(barCount, source.ring.size()) };
+
+        Bars bars;
+        bars.reserve(available);
+        for (auto i { barCount - available }; i < barCount; ++i) {
+            bars.emplace_back(source.ring[i % source.ring.size()].load());
+        }
+        return bars;
+    });
+}
+
+auto TradeStats::AtomicBar::load() const -> Bar
+{
+    return {
+        .start = start.load(std::memory_order_relaxed),
+        .open = open.load(std::memory_order_relaxed),
+        .high = high.load(std::memory_order_relaxed),
+        .low = low.load(std::memory_order_relaxed),
+        .close = close.load(std::memory_order_relaxed),
+        .volume = volume.load(std::memory_order_relaxed),
+        .notional = notional.load(std::memory_order_relaxed),
+        .tradeCount = tradeCount.load(std::memory_order_relaxed),
+    };
+}
+
+auto TradeStats::AtomicBar::store(const Bar& bar) -> void
+{
+    start.store(bar.start, std::memory_order_relaxed);
+    open.store(bar.open, std::memory_order_relaxed);
+    high.store(bar.high, std::memory_order_relaxed);
+    low.store(bar.low, std::memory_order_relaxed);
+    close.store(bar.close, std::memory_order_relaxed);
+    volume.store(bar.volume, std::memory_order_relaxed);
+    notional.store(bar.notional, std::memory_order_relaxed);
+    tradeCount.store(bar.tradeCount, std::memory_order_relaxed);
+}
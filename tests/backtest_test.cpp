@@ -0,0 +1,101 @@
+#include "backtest.hpp"
+#include "capture.hpp"
+#include "replay.hpp"
+#include "gtest/gtest.h"
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+namespace {
+// Deterministic flow across several instruments, with crossing orders, day orders and cancels.
+auto generateEvents(std::size_t count) -> Events
+{
+    Events events;
+    std::uint32_t state { 12345 };
+    auto next = [&state] {
+        state = state * 1103515245 + 12345;
+        return state >> 8U;
+    };
+
+    for (std::size_t i { 1 }; i <= count; ++i) {
+        Event event;
+        event.timestamp = i;
+        event.instrument = next() % 7;
+        if (i > 10 && next() % 4 == 0) {
+            event.kind = EventKind::cancel;
+            event.id = static_cast<OrderId>(next() % i);
+        } else {
+            event.kind = EventKind::place;
+            event.id = static_cast<OrderId>(i);
+            event.type = static_cast<std::uint8_t>(i % 3 == 0 ? OrderType::day : OrderType::gtc);
+            event.side = static_cast<std::uint8_t>(next() % 2 == 0 ? Side::buy : Side::sell);
+            event.price = 95 + next() % 10;
+            event.quantity = 1 + next() % 50;
+        }
+        events.emplace_back(event);
+    }
+    return events;
+}
+} // namespace
+
+TEST(BacktestTest, splitByInstrument)
+{
+    const auto events { generateEvents(1000) };
+    const auto streams { splitByInstrument(events) };
+    ASSERT_EQ(streams.size(), 7);
+
+    std::size_t total { 0 };
+    for (std::size_t i { 0 }; i < streams.size(); ++i) {
+        EXPECT_EQ(streams[i].instrument, i);
+        for (std::size_t j { 1 }; j < streams[i].events.size(); ++j) {
+            EXPECT_LT(streams[i].events[j - 1].timestamp, streams[i].events[j].timestamp);
+        }
+        total += streams[i].events.size();
+    }
+    EXPECT_EQ(total, events.size());
+}
+
+TEST(BacktestTest, matchesSequentialReplay)
+{
+    const auto events { generateEvents(20000) };
+    const auto streams { splitByInstrument(events) };
+
+    Replayer replayer;
+    std::size_t tradeCount { 0 };
+    for (const auto& event : events) {
+        tradeCount += replayer.apply(event).size();
+    }
+
+    const auto serial { runBacktest(streams, { .threads = 1, .batchSize = 100, .bookOptions = {} }) };
+    const auto parallel { runBacktest(streams, { .threads = 4, .batchSize = 7, .bookOptions = {} }) };
+
+    EXPECT_EQ(serial.eventCount, events.size());
+    EXPECT_EQ(serial.tradeCount, tradeCount);
+    EXPECT_GT(serial.volume, 0);
+    EXPECT_EQ(serial.bookDigest, replayer.bookDigest());
+
+    EXPECT_EQ(parallel.eventCount, serial.eventCount);
+    EXPECT_EQ(parallel.tradeCount, serial.tradeCount);
+    EXPECT_EQ(parallel.volume, serial.volume);
+    EXPECT_EQ(parallel.bookDigest, serial.bookDigest);
+    EXPECT_EQ(parallel.tradeDigest, serial.tradeDigest);
+
+    ASSERT_EQ(parallel.books.size(), streams.size());
+    for (std::size_t i { 0 }; i < streams.size(); ++i) {
+        EXPECT_EQ(parallel.books[i].instrument, streams[i].instrument);
+        EXPECT_EQ(parallel.books[i].eventCount, streams[i].events.size());
+        EXPECT_EQ(parallel.books[i].trades.size(), parallel.books[i].session.tradeCount);
+        EXPECT_EQ(parallel.books[i].restingOrders, serial.books[i].restingOrders);
+
+        // Trades are timestamped with capture time, which is tiny here, rather than when the backtest ran.
+        EXPECT_EQ(parallel.books[i].session.start, serial.books[i].session.start);
+        EXPECT_LE(parallel.books[i].session.start, events.size());
+    }
+}
+
+TEST(BacktestTest, emptyStreams)
+{
+    const auto result { runBacktest({}) };
+    EXPECT_TRUE(result.books.empty());
+    EXPECT_EQ(result.eventCount, 0);
+    EXPECT_EQ(result.tradeDigest, Digest {}.value());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
@@ -0,0 +1,108 @@
+#include "capture.hpp"
+#include "order.hpp"
+#include "gtest/gtest.h"
+#include <filesystem>
+#include <sstream>
+#include <stdexcept>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(CaptureTest, parseCsv)
+{
+    std::istringstream input { "timestamp,instrument,action,id,type,side,price,quantity\n"
+                               "100,7,place,1,gtc,buy,99,150\r\n"
+                               "\n"
+                               "250,7,modify,1,,,98,100\n"
+                               "300,8,place,2,market,sell,,25\n"
+                               "400,7,cancel,1\n" };
+
+    const auto events { parseCsv(input) };
+    ASSERT_EQ(events.size(), 4);
+
+    EXPECT_EQ(events[0].timestamp, 100);
+    EXPECT_EQ(events[0].instrument, 7);
+    EXPECT_EQ(events[0].kind, EventKind::place);
+    EXPECT_EQ(events[0].id, 1);
+    EXPECT_EQ(events[0].orderType(), OrderType::gtc);
+    EXPECT_EQ(events[0].orderSide(), Side::buy);
+    EXPECT_EQ(events[0].price, 99);
+    EXPECT_EQ(events[0].quantity, 150);
+
+    EXPECT_EQ(events[1].kind, EventKind::modify);
+    EXPECT_EQ(events[1].price, 98);
+    EXPECT_EQ(events[1].quantity, 100);
+
+    EXPECT_EQ(events[2].instrument, 8);
+    EXPECT_EQ(events[2].orderType(), OrderType::market);
+    EXPECT_EQ(events[2].orderSide(), Side::sell);
+    EXPECT_EQ(events[2].price, Constants::invalidPrice);
+
+    EXPECT_EQ(events[3].kind, EventKind::cancel);
+    EXPECT_EQ(events[3].id, 1);
+}
+
+TEST(CaptureTest, parseMalformedCsv)
+{
+    std::istringstream badAction { "100,7,amend,1,gtc,buy,99,150\n" };
+    EXPECT_THROW(auto discard { parseCsv(badAction) }, std::runtime_error);
+
+    std::istringstream badNumber { "100,7,place,1,gtc,buy,9x,150\n" };
+    EXPECT_THROW(auto discard { parseCsv(badNumber) }, std::runtime_error);
+
+    std::istringstream tooFewFields { "100,7,cancel\n" };
+    EXPECT_THROW(auto discard { parseCsv(tooFewFields) }, std::runtime_error);
+
+    std::istringstream placeWithoutSide { "100,7,place,1\n" };
+    EXPECT_THROW(auto discard { parseCsv(placeWithoutSide) }, std::runtime_error);
+
+    std::istringstream limitWithoutPrice { "100,7,place,1,gtc,buy,,150\n" };
+    EXPECT_THROW(auto discard { parseCsv(limitWithoutPrice) }, std::runtime_error);
+
+    std::istringstream placeWithoutQuantity { "100,7,place,1,market,sell\n" };
+    EXPECT_THROW(auto discard { parseCsv(placeWithoutQuantity) }, std::runtime_error);
+
+    std::istringstream modifyWithoutQuantity { "100,7,modify,1,,,99\n" };
+    EXPECT_THROW(auto discard { parseCsv(modifyWithoutQuantity) }, std::runtime_error);
+}
+
+TEST(CaptureTest, writeAndMapCapture)
+{
+    std::istringstream input { "100,7,place,1,gtc,buy,99,150\n"
+                               "200,7,place,2,ioc,sell,98,50\n"
+                               "300,7,cancel,1\n" };
+    const auto events { parseCsv(input) };
+
+    const auto path { std::filesystem::temp_directory_path() / "broka_capture_test.bin" };
+    writeCapture(path, events);
+
+    {
+        const Capture capture { path };
+        const auto mapped { capture.events() };
+        ASSERT_EQ(mapped.size(), events.size());
+        for (std::size_t i { 0 }; i < events.size(); ++i) {
+            EXPECT_EQ(mapped[i].timestamp, events[i].timestamp);
+            EXPECT_EQ(mapped[i].kind, events[i].kind);
+            EXPECT_EQ(mapped[i].id, events[i].id);
+            EXPECT_EQ(mapped[i].type, events[i].type);
+            EXPECT_EQ(mapped[i].side, events[i].side);
+            EXPECT_EQ(mapped[i].price, events[i].price);
+            EXPECT_EQ(mapped[i].quantity, events[i].quantity);
+        }
+    }
+
+    auto corrupt { events };
+    corrupt[1].side = 7;
+    writeCapture(path, corrupt);
+    EXPECT_THROW(Capture { path }, std::runtime_error);
+    corrupt[1].side = events[1].side;
+    corrupt[2].kind = static_cast<EventKind>(9);
+    writeCapture(path, corrupt);
+    EXPECT_THROW(Capture { path }, std::runtime_error);
+
+    writeCapture(path, events);
+    std::filesystem::resize_file(path, sizeof(CaptureHeader) + sizeof(Event));
+    EXPECT_THROW(Capture { path }, std::runtime_error);
+
+    std::filesystem::remove(path);
+    EXPECT_THROW(Capture { path }, std::runtime_error);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
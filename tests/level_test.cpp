@@ -0,0 +1,131 @@
+#include "level.hpp"
+#include "order.hpp"
+#include "gtest/gtest.h"
+#include <memory>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(LevelTest, fillAndPopFront)
+{
+    Level level;
+    OrderPtr order1 { std::make_shared<Order>(1, OrderType::gtc, Side::sell, 100, 30) };
+    OrderPtr order2 { std::make_shared<Order>(2, OrderType::day, Side::sell, 100, 20) };
+
+    EXPECT_EQ(level.append(order1), 0);
+    EXPECT_EQ(level.append(order2), 1);
+    EXPECT_EQ(level.quantity(), 50);
+    EXPECT_EQ(level.front().id, 1);
+    EXPECT_EQ(level.front().orderSide(), Side::sell);
+    EXPECT_EQ(level.orders()[1].orderType(), OrderType::day);
+
+    // Fills are only written back to the caller's order when synced or popped.
+    level.fillFront(5);
+    level.fillFront(5);
+    EXPECT_EQ(level.front().remainingQuantity, 20);
+    EXPECT_EQ(order1->remainingQuantity(), 30);
+    EXPECT_EQ(level.quantity(), 40);
+    level.syncFront();
+    EXPECT_EQ(order1->remainingQuantity(), 20);
+    level.syncFront();
+    EXPECT_EQ(order1->remainingQuantity(), 20);
+
+    level.fillFront(20);
+    level.popFront();
+    EXPECT_TRUE(order1->isFilled());
+    EXPECT_EQ(level.front().id, 2);
+    EXPECT_EQ(level.orders().size(), 1);
+
+    level.popFront();
+    EXPECT_TRUE(level.empty());
+    EXPECT_DEATH(level.popFront(), ".*");
+}
+
+TEST(LevelTest, erase)
+{
+    Level level;
+    for (OrderId id { 1 }; id <= 200; ++id) {
+        [[maybe_unused]] auto discard { level.append(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 99, 1)) };
+    }
+
+    // Consume enough from the front to trigger compaction, which must not disturb ticket lookups.
+    for (auto i { 0 }; i < 150; ++i) {
+        level.fillFront(1);
+        level.popFront();
+    }
+    EXPECT_EQ(level.front().id, 151);
+    EXPECT_EQ(level.find(170).id, 171);
+
+    level.erase(170);
+    level.erase(150);
+    EXPECT_EQ(level.front().id, 152);
+    EXPECT_EQ(level.orders().size(), 48);
+    EXPECT_EQ(level.quantity(), 48);
+    EXPECT_DEATH(level.erase(170), ".*");
+}
+
+TEST(LevelTest, killAndCompact)
+{
+    Level level;
+    OrderPtr order1 { std::make_shared<Order>(1, OrderType::gtc, Side::buy, 99, 10) };
+    OrderPtr order2 { std::make_shared<Order>(2, OrderType::gtc, Side::buy, 99, 20) };
+    OrderPtr order3 { std::make_shared<Order>(3, OrderType::gtc, Side::buy, 99, 30) };
+    [[maybe_unused]] auto discard { level.append(order1) };
+    discard = level.append(order2);
+    discard = level.append(order3);
+
+    level.kill(1);
+    EXPECT_EQ(level.tombstones(), 1);
+    EXPECT_EQ(level.quantity(), 40);
+    EXPECT_EQ(level.orders().size(), 3);
+    EXPECT_EQ(order2.use_count(), 1);
+
+    // Killing the front skips over the tombstone behind it.
+    level.kill(0);
+    EXPECT_EQ(level.tombstones(), 0);
+    EXPECT_EQ(level.front().id, 3);
+    EXPECT_EQ(level.quantity(), 30);
+
+    level.kill(2);
+    EXPECT_TRUE(level.empty());
+    EXPECT_EQ(level.quantity(), 0);
+}
+
+TEST(LevelTest, shouldCompact)
+{
+    Level level;
+    for (OrderId id { 1 }; id <= 200; ++id) {
+        [[maybe_unused]] auto discard { level.append(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 99, 1)) };
+    }
+    for (Ticket ticket { 1 }; ticket < 200; ticket += 2) {
+        level.kill(ticket);
+    }
+    EXPECT_EQ(level.tombstones(), 100);
+    EXPECT_TRUE(level.shouldCompact(0.25));
+    EXPECT_FALSE(level.shouldCompact(0.5));
+
+    level.compact();
+    EXPECT_EQ(level.tombstones(), 0);
+    EXPECT_EQ(level.orders().size(), 100);
+    EXPECT_EQ(level.quantity(), 100);
+    EXPECT_EQ(level.find(198).id, 199);
+
+    level.erase(100);
+    EXPECT_EQ(level.find(102).id, 103);
+}
+
+TEST(LevelTest, renumber)
+{
+    Level level;
+    for (OrderId id { 1 }; id <= 4; ++id) {
+        [[maybe_unused]] auto discard { level.append(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 99, 1)) };
+    }
+    level.erase(1);
+    level.popFront();
+    EXPECT_FALSE(level.ticketsExhausted());
+
+    level.renumber();
+    EXPECT_EQ(level.orders().size(), 2);
+    EXPECT_EQ(level.find(0).id, 3);
+    EXPECT_EQ(level.find(1).id, 4);
+    EXPECT_EQ(level.append(std::make_shared<Order>(5, OrderType::gtc, Side::buy, 99, 1)), 2);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
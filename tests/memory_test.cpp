@@ -0,0 +1,67 @@
+#include "memory.hpp"
+#include "gtest/gtest.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(MemoryTest, countsAllocations)
+{
+    MemoryCounter counter;
+    {
+        std::vector<std::uint64_t, AccountingAllocator<std::uint64_t>> values { AccountingAllocator<std::uint64_t> { &counter } };
+        values.reserve(100);
+        EXPECT_EQ(counter.bytes(), 800);
+
+        values.reserve(200);
+        EXPECT_EQ(counter.bytes(), 1600);
+        EXPECT_EQ(counter.peakBytes(), 2400);
+    }
+    EXPECT_EQ(counter.bytes(), 0);
+    EXPECT_EQ(counter.peakBytes(), 2400);
+}
+
+TEST(MemoryTest, forwardsToParent)
+{
+    MemoryCounter total;
+    MemoryCounter first { &total };
+    MemoryCounter second { &total };
+
+    // The children peak at different times, so the combined peak is below the sum of theirs.
+    first.allocate(100);
+    first.deallocate(100);
+    second.allocate(60);
+    EXPECT_EQ(total.bytes(), 60);
+    EXPECT_EQ(total.peakBytes(), 100);
+    EXPECT_EQ(first.peakBytes() + second.peakBytes(), 160);
+}
+
+TEST(MemoryTest, countsRebound)
+{
+    struct alignas(64) Wide {
+        std::uint8_t value;
+    };
+    using Allocator = AccountingAllocator<std::pair<const int, Wide>>;
+
+    MemoryCounter counter;
+    std::map<int, Wide, std::less<>, Allocator> values { Allocator { &counter } };
+    for (auto i { 0 }; i < 10; ++i) {
+        values[i].value = static_cast<std::uint8_t>(i);
+    }
+    EXPECT_GE(counter.bytes(), 10 * sizeof(std::pair<const int, Wide>));
+    for (const auto& [key, value] : values) {
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&value) % 64, 0); // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    values.clear();
+    EXPECT_EQ(counter.bytes(), 0);
+}
+
+TEST(MemoryTest, allowsNoCounter)
+{
+    std::vector<int, AccountingAllocator<int>> values;
+    values.assign(10, 1);
+    EXPECT_EQ(values.get_allocator().counter(), nullptr);
+    EXPECT_EQ(values.get_allocator(), AccountingAllocator<double> {});
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
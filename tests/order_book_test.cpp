@@ -1,8 +1,46 @@
 #include "order.hpp"
 #include "order_book.hpp"
 #include "gtest/gtest.h"
+#include <thread>
+#include <vector>
 
 // NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(OrderBookTest, busyPoll)
+{
+    // Yielding, as the test may share a core with the matching thread.
+    OrderBook orderBook { { .threadingModel = ThreadingModel::busyPoll, .spinPolicy = SpinPolicy::yield, .requestQueueCapacity = 4 } };
+    OrderPtr order1 { std::make_shared<Order>(1, OrderType::gtc, Side::buy, 99, 150) };
+    OrderPtr order2 { std::make_shared<Order>(2, OrderType::gtc, Side::sell, 99, 100) };
+
+    auto trades { orderBook.placeOrder(order1) };
+    EXPECT_TRUE(trades.empty());
+    trades = orderBook.placeOrder(order2);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity(), 100);
+    EXPECT_EQ(order1->remainingQuantity(), 50);
+
+    trades = orderBook.updateOrder({ 1, 100, 75 });
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].price, 100);
+    orderBook.cancelOrder(1);
+    EXPECT_EQ(orderBook.size(), 0);
+
+    // More callers than queue slots, so some must wait for space.
+    std::vector<std::thread> callers;
+    for (OrderId caller { 0 }; caller < 8; ++caller) {
+        callers.emplace_back([&orderBook, caller] {
+            for (OrderId i { 0 }; i < 100; ++i) {
+                auto discard { orderBook.placeOrder(std::make_shared<Order>(caller * 100 + i + 10, OrderType::gtc, Side::buy, 90, 1)) };
+            }
+        });
+    }
+    for (auto& caller : callers) {
+        caller.join();
+    }
+    EXPECT_EQ(orderBook.size(), 800);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 800);
+}
+
 TEST(OrderBookTest, cancelOrder)
 {
     OrderBook orderBook;
@@ -43,6 +81,114 @@ TEST(OrderBookTest, cancelOrder)
     EXPECT_EQ(orderBook.levelsInfo().askLevelsInfo().size(), 0);
 }
 
+TEST(OrderBookTest, cancelOrderWithinLevel)
+{
+    OrderBook orderBook;
+    for (OrderId id { 1 }; id <= 4; ++id) {
+        auto discard { orderBook.placeOrder(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 99, id * 10)) };
+    }
+
+    orderBook.cancelOrder(2);
+    orderBook.cancelOrder(1);
+    EXPECT_EQ(orderBook.size(), 2);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 70);
+
+    auto trades { orderBook.placeOrder(std::make_shared<Order>(5, OrderType::gtc, Side::sell, 99, 35)) };
+    ASSERT_EQ(trades.size(), 2);
+    EXPECT_EQ(trades[0].buySideInfo().orderId, 3);
+    EXPECT_EQ(trades[0].quantity(), 30);
+    EXPECT_EQ(trades[1].buySideInfo().orderId, 4);
+    EXPECT_EQ(trades[1].quantity(), 5);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 35);
+}
+
+TEST(OrderBookTest, lazyCancelOrder)
+{
+    OrderBook orderBook { { .cancelMode = CancelMode::lazy } };
+    for (OrderId id { 1 }; id <= 4; ++id) {
+        auto discard { orderBook.placeOrder(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 99, id * 10)) };
+    }
+    auto discard { orderBook.placeOrder(std::make_shared<Order>(5, OrderType::gtc, Side::buy, 98, 50)) };
+
+    orderBook.cancelOrder(2);
+    orderBook.cancelOrder(3);
+    EXPECT_EQ(orderBook.size(), 3);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 50);
+
+    auto trades { orderBook.placeOrder(std::make_shared<Order>(6, OrderType::fok, Side::sell, 98, 75)) };
+    ASSERT_EQ(trades.size(), 3);
+    EXPECT_EQ(trades[0].buySideInfo().orderId, 1);
+    EXPECT_EQ(trades[0].quantity(), 10);
+    EXPECT_EQ(trades[1].buySideInfo().orderId, 4);
+    EXPECT_EQ(trades[1].quantity(), 40);
+    EXPECT_EQ(trades[2].buySideInfo().orderId, 5);
+    EXPECT_EQ(trades[2].quantity(), 25);
+    EXPECT_EQ(orderBook.size(), 1);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo().size(), 1);
+
+    orderBook.cancelOrder(5);
+    orderBook.cancelOrder(5);
+    EXPECT_EQ(orderBook.size(), 0);
+    EXPECT_TRUE(orderBook.levelsInfo().bidLevelsInfo().empty());
+
+    // Enough cancels to compact the level several times, with every compaction leaving later orders to be found.
+    for (OrderId id { 10 }; id < 410; ++id) {
+        discard = orderBook.placeOrder(std::make_shared<Order>(id, OrderType::gtc, Side::sell, 101, 1));
+    }
+    for (OrderId id { 11 }; id < 410; id += 2) {
+        orderBook.cancelOrder(id);
+    }
+    EXPECT_EQ(orderBook.size(), 200);
+    EXPECT_EQ(orderBook.levelsInfo().askLevelsInfo()[0].quantity, 200);
+    for (OrderId id { 408 }; id >= 10; id -= 2) {
+        orderBook.cancelOrder(id);
+    }
+    EXPECT_EQ(orderBook.size(), 0);
+    EXPECT_TRUE(orderBook.levelsInfo().askLevelsInfo().empty());
+}
+
+TEST(OrderBookTest, memoryStats)
+{
+    OrderBook orderBook;
+    auto stats { orderBook.memoryStats() };
+    EXPECT_EQ(stats.liveOrders, 0);
+    EXPECT_EQ(stats.levelArrays.bytes, 0);
+    EXPECT_EQ(stats.bidLevelNodes.bytes + stats.askLevelNodes.bytes, 0);
+
+    for (OrderId id { 1 }; id <= 100; ++id) {
+        auto discard { orderBook.placeOrder(std::make_shared<Order>(id, OrderType::gtc, Side::buy, 90 + id % 5, 10)) };
+    }
+    auto discard { orderBook.placeOrder(std::make_shared<Order>(101, OrderType::gtc, Side::sell, 100, 10)) };
+
+    stats = orderBook.memoryStats();
+    EXPECT_EQ(stats.liveOrders, 101);
+    EXPECT_EQ(stats.peakLiveOrders, 101);
+    EXPECT_EQ(stats.bidLevels, 5);
+    EXPECT_EQ(stats.askLevels, 1);
+    EXPECT_EQ(stats.peakLevels, 6);
+    EXPECT_GE(stats.bidLevelNodes.bytes, 5 * sizeof(Level));
+    EXPECT_GE(stats.askLevelNodes.bytes, sizeof(Level));
+    EXPECT_GE(stats.levelArrays.bytes, 101 * (sizeof(HotOrder) + sizeof(OrderPtr)));
+    EXPECT_GE(stats.orderIndex.bytes, stats.indexBuckets * sizeof(void*));
+    EXPECT_GT(stats.indexLoadFactor, 0.0);
+    EXPECT_EQ(stats.callerOrderBytes, 101 * Constants::sharedOrderBytes);
+    EXPECT_EQ(stats.bookBytes(), stats.bidLevelNodes.bytes + stats.askLevelNodes.bytes + stats.levelArrays.bytes + stats.orderIndex.bytes);
+
+    const auto peakBytes { stats.bookBytes() };
+    discard = orderBook.placeOrder(std::make_shared<Order>(102, OrderType::gtc, Side::sell, 90, 1000));
+
+    stats = orderBook.memoryStats();
+    EXPECT_EQ(stats.liveOrders, 1);
+    EXPECT_EQ(stats.peakLiveOrders, 102);
+    EXPECT_EQ(stats.bidLevels, 0);
+    EXPECT_EQ(stats.bidLevelNodes.bytes, 0);
+    EXPECT_GE(stats.bidLevelNodes.peakBytes, 5 * sizeof(Level));
+    EXPECT_LT(stats.bookBytes(), peakBytes);
+    EXPECT_GE(stats.peakBookBytes, peakBytes);
+    EXPECT_LE(stats.peakBookBytes,
+        stats.bidLevelNodes.peakBytes + stats.askLevelNodes.peakBytes + stats.levelArrays.peakBytes + stats.orderIndex.peakBytes);
+}
+
 TEST(OrderBookTest, placeFokOrder)
 {
     OrderBook orderBook;
@@ -211,6 +357,43 @@ TEST(OrderBookTest, placeMarketOrder)
     EXPECT_EQ(order6->remainingQuantity(), 25);
 }
 
+TEST(OrderBookTest, tradeStats)
+{
+    OrderBook orderBook;
+    OrderPtr order1 { std::make_shared<Order>(1, OrderType::gtc, Side::sell, 101, 10) };
+    OrderPtr order2 { std::make_shared<Order>(2, OrderType::gtc, Side::sell, 102, 30) };
+    OrderPtr order3 { std::make_shared<Order>(3, OrderType::gtc, Side::buy, 105, 20) };
+    OrderPtr order4 { std::make_shared<Order>(4, OrderType::gtc, Side::buy, 99, 5) };
+    OrderPtr order5 { std::make_shared<Order>(5, OrderType::gtc, Side::sell, 98, 5) };
+
+    auto trades { orderBook.placeOrder(order1) };
+    trades = orderBook.placeOrder(order2);
+    EXPECT_EQ(orderBook.tradeStats().session().tradeCount, 0);
+
+    // Aggressive orders trade at the resting order's price.
+    trades = orderBook.placeOrder(order3);
+    trades = orderBook.placeOrder(order4);
+    trades = orderBook.placeOrder(order5);
+
+    const auto& stats { orderBook.tradeStats() };
+    const auto session { stats.session() };
+    EXPECT_EQ(stats.lastPrice(), 99);
+    EXPECT_EQ(session.open, 101);
+    EXPECT_EQ(session.high, 102);
+    EXPECT_EQ(session.low, 99);
+    EXPECT_EQ(session.close, 99);
+    EXPECT_EQ(session.volume, 25);
+    EXPECT_EQ(session.tradeCount, 3);
+    EXPECT_DOUBLE_EQ(session.vwap(), (101.0 * 10 + 102.0 * 10 + 99.0 * 5) / 25);
+
+    // The trades may straddle an interval boundary.
+    std::uint64_t barVolume { 0 };
+    for (const auto& bar : stats.bars(0)) {
+        barVolume += bar.volume;
+    }
+    EXPECT_EQ(barVolume, 25);
+}
+
 TEST(OrderBookTest, updateOrder)
 {
     OrderBook orderBook;
@@ -250,4 +433,35 @@ TEST(OrderBookTest, updateOrder)
     EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 175);
     EXPECT_TRUE(orderBook.levelsInfo().askLevelsInfo().empty());
 }
+
+TEST(OrderBookTest, zeroQuantityOrders)
+{
+    for (const auto cancelMode : { CancelMode::eager, CancelMode::lazy }) {
+        OrderBook orderBook { { .cancelMode = cancelMode } };
+
+        // Never rests, so cannot be skipped over by matching while still indexed.
+        auto discard { orderBook.placeOrder(std::make_shared<Order>(1, OrderType::gtc, Side::buy, 100, 5)) };
+        discard = orderBook.placeOrder(std::make_shared<Order>(2, OrderType::gtc, Side::buy, 100, 0));
+        discard = orderBook.placeOrder(std::make_shared<Order>(3, OrderType::gtc, Side::buy, 100, 5));
+        EXPECT_EQ(orderBook.size(), 2);
+
+        // Updating to nothing cancels.
+        discard = orderBook.placeOrder(std::make_shared<Order>(4, OrderType::gtc, Side::buy, 100, 5));
+        discard = orderBook.updateOrder({ 4, 100, 0 });
+        EXPECT_EQ(orderBook.size(), 2);
+
+        auto trades { orderBook.placeOrder(std::make_shared<Order>(5, OrderType::gtc, Side::sell, 100, 5)) };
+        ASSERT_EQ(trades.size(), 1);
+        EXPECT_EQ(trades[0].buySideInfo().orderId, 1);
+        trades = orderBook.placeOrder(std::make_shared<Order>(6, OrderType::gtc, Side::sell, 100, 5));
+        ASSERT_EQ(trades.size(), 1);
+        EXPECT_EQ(trades[0].buySideInfo().orderId, 3);
+
+        EXPECT_EQ(orderBook.size(), 0);
+        EXPECT_TRUE(orderBook.levelsInfo().bidLevelsInfo().empty());
+        orderBook.cancelOrder(2);
+        orderBook.cancelOrder(4);
+        EXPECT_EQ(orderBook.size(), 0);
+    }
+}
 // NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
@@ -0,0 +1,139 @@
+#include "capture.hpp"
+#include "order.hpp"
+#include "order_book.hpp"
+#include "replay.hpp"
+#include "gtest/gtest.h"
+#include <memory>
+#include <sstream>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(ReplayTest, applyEvent)
+{
+    std::istringstream input { "100,1,place,1,gtc,buy,99,150\n"
+                               "200,1,place,2,gtc,sell,101,25\n"
+                               "300,1,modify,2,,,99,50\n"
+                               "400,1,place,3,market,sell,,30\n"
+                               "500,1,cancel,1\n" };
+    const auto events { parseCsv(input) };
+
+    OrderBook orderBook;
+    auto trades { applyEvent(orderBook, events[0]) };
+    EXPECT_TRUE(trades.empty());
+
+    trades = applyEvent(orderBook, events[1]);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(orderBook.size(), 2);
+
+    trades = applyEvent(orderBook, events[2]);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity(), 50);
+    EXPECT_EQ(trades[0].buySideInfo().orderId, 1);
+    EXPECT_EQ(trades[0].sellSideInfo().orderId, 2);
+
+    trades = applyEvent(orderBook, events[3]);
+    ASSERT_EQ(trades.size(), 1);
+    EXPECT_EQ(trades[0].quantity(), 30);
+    EXPECT_EQ(orderBook.levelsInfo().bidLevelsInfo()[0].quantity, 70);
+
+    trades = applyEvent(orderBook, events[4]);
+    EXPECT_TRUE(trades.empty());
+    EXPECT_EQ(orderBook.size(), 0);
+}
+
+TEST(ReplayTest, barsFollowCaptureTime)
+{
+    std::istringstream input { "1200000000,1,place,1,gtc,buy,99,150\n"
+                               "1500000000,1,place,2,gtc,sell,99,10\n"
+                               "2500000000,1,place,3,gtc,sell,98,20\n"
+                               "3700000000,1,place,4,gtc,sell,99,30\n" };
+    const auto events { parseCsv(input) };
+
+    OrderBook orderBook { { .threadingModel = ThreadingModel::confined, .tradeClock = TradeClock::manual } };
+    for (const auto& event : events) {
+        auto discard { applyEvent(orderBook, event) };
+    }
+
+    const auto& tradeStats { orderBook.tradeStats() };
+    EXPECT_EQ(tradeStats.session().start, 1'500'000'000);
+    const auto bars { tradeStats.bars(0) };
+    ASSERT_EQ(bars.size(), 3);
+    EXPECT_EQ(bars[0].start, 1'000'000'000);
+    EXPECT_EQ(bars[0].volume, 10);
+    EXPECT_EQ(bars[1].start, 2'000'000'000);
+    EXPECT_EQ(bars[1].volume, 20);
+    EXPECT_EQ(bars[2].start, 3'000'000'000);
+    EXPECT_EQ(bars[2].volume, 30);
+
+    // Books on the system clock ignore the capture time.
+    OrderBook liveBook { { .threadingModel = ThreadingModel::confined } };
+    for (const auto& event : events) {
+        auto discard { applyEvent(liveBook, event) };
+    }
+    EXPECT_GT(liveBook.tradeStats().session().start, 3'700'000'000);
+}
+
+TEST(ReplayTest, bookDigest)
+{
+    std::istringstream input { "100,1,place,1,gtc,buy,99,150\n"
+                               "200,2,place,2,gtc,sell,101,25\n"
+                               "300,1,place,3,gtc,sell,100,10\n" };
+    const auto events { parseCsv(input) };
+
+    Replayer replayer1;
+    Replayer replayer2;
+    for (const auto& event : events) {
+        auto discard { replayer1.apply(event) };
+        discard = replayer2.apply(event);
+    }
+    EXPECT_EQ(replayer1.bookCount(), 2);
+    EXPECT_EQ(replayer1.bookDigest(), replayer2.bookDigest());
+
+    auto cancel { events[2] };
+    cancel.kind = EventKind::cancel;
+    auto discard { replayer2.apply(cancel) };
+    EXPECT_NE(replayer1.bookDigest(), replayer2.bookDigest());
+}
+
+TEST(ReplayTest, replaysDayOrders)
+{
+    std::istringstream input { "100,1,place,1,day,buy,99,150\n"
+                               "200,1,place,2,day,sell,101,25\n"
+                               "300,1,place,3,day,sell,99,50\n" };
+    const auto events { parseCsv(input) };
+
+    // Day orders must never expire by the wall clock during a replay, so they digest the same as gtc orders.
+    Replayer dayReplayer;
+    Replayer gtcReplayer;
+    for (const auto& event : events) {
+        auto gtcEvent { event };
+        gtcEvent.type = static_cast<std::uint8_t>(OrderType::gtc);
+        auto discard { dayReplayer.apply(event) };
+        discard = gtcReplayer.apply(gtcEvent);
+    }
+    EXPECT_EQ(dayReplayer.bookDigest(), gtcReplayer.bookDigest());
+
+    OrderBook expected { { .threadingModel = ThreadingModel::confined } };
+    auto discard { expected.placeOrder(std::make_shared<Order>(1, OrderType::gtc, Side::buy, 99, 100)) };
+    discard = expected.placeOrder(std::make_shared<Order>(2, OrderType::gtc, Side::sell, 101, 25));
+    Digest digest;
+    digestBook(digest, 1, expected);
+    EXPECT_EQ(dayReplayer.bookDigest(), digest.value());
+}
+
+TEST(ReplayTest, tradeDigest)
+{
+    const Trade trade1 { 10, { 1, 100 }, { 2, 100 } };
+    const Trade trade2 { 20, { 3, 101 }, { 4, 100 } };
+
+    Digest digest1;
+    digest1.add(trade1);
+    digest1.add(trade2);
+
+    Digest digest2;
+    digest2.add(trade2);
+    digest2.add(trade1);
+
+    EXPECT_NE(digest1.value(), Digest {}.value());
+    EXPECT_NE(digest1.value(), digest2.value());
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
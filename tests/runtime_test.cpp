@@ -0,0 +1,89 @@
+#include "runtime.hpp"
+#include "gtest/gtest.h"
+#include <array>
+#include <atomic>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#include <thread>
+#include <vector>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(RuntimeTest, requestQueueIsFifoAndBounded)
+{
+    RequestQueue queue { 3 }; // Rounded up to 4.
+    std::array<Request, 5> requests;
+
+    EXPECT_EQ(queue.tryPop(), nullptr);
+    for (auto i { 0 }; i < 4; ++i) {
+        EXPECT_TRUE(queue.tryPush(&requests.at(i)));
+    }
+    EXPECT_FALSE(queue.tryPush(&requests.at(4)));
+
+    EXPECT_EQ(queue.tryPop(), &requests.at(0));
+    EXPECT_TRUE(queue.tryPush(&requests.at(4)));
+    for (auto i { 1 }; i < 5; ++i) {
+        EXPECT_EQ(queue.tryPop(), &requests.at(i));
+    }
+    EXPECT_EQ(queue.tryPop(), nullptr);
+}
+
+TEST(RuntimeTest, requestQueueAcceptsConcurrentProducers)
+{
+    constexpr auto producers { 4 };
+    constexpr auto perProducer { 1000 };
+
+    RequestQueue queue { 8 };
+    std::vector<Request> requests(producers * perProducer);
+    std::vector<std::thread> threads;
+    for (auto producer { 0 }; producer < producers; ++producer) {
+        threads.emplace_back([&queue, &requests, producer] {
+            Spinner spinner { SpinPolicy::yield };
+            for (auto i { 0 }; i < perProducer; ++i) {
+                while (!queue.tryPush(&requests.at(producer * perProducer + i))) {
+                    spinner.spin();
+                }
+            }
+        });
+    }
+
+    // Each producer's requests must arrive in the order it pushed them.
+    std::array<int, producers> next {};
+    Spinner spinner { SpinPolicy::backoff };
+    for (auto popped { 0 }; popped < producers * perProducer;) {
+        auto* request { queue.tryPop() };
+        if (request == nullptr) {
+            spinner.spin();
+            continue;
+        }
+        spinner.reset();
+        const auto index { static_cast<int>(request - requests.data()) };
+        const auto producer { index / perProducer };
+        EXPECT_EQ(index % perProducer, next.at(producer)++);
+        ++popped;
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(queue.tryPop(), nullptr);
+}
+
+TEST(RuntimeTest, pinThread)
+{
+    std::atomic<bool> stop { false };
+    std::thread thread { [&stop] {
+        while (!stop.load()) {
+            std::this_thread::yield();
+        }
+    } };
+
+    EXPECT_TRUE(pinThread(thread, -1));
+#ifdef __linux__
+    EXPECT_TRUE(pinThread(thread, ::sched_getcpu())); // A core this process is allowed to use.
+#endif
+    EXPECT_FALSE(pinThread(thread, 1 << 20));
+
+    stop = true;
+    thread.join();
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
@@ -0,0 +1,54 @@
+#include "thread_pool.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <functional>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(ThreadPoolTest, runsSubmittedTasks)
+{
+    ThreadPool pool { 4 };
+    EXPECT_EQ(pool.size(), 4);
+
+    std::atomic<int> sum { 0 };
+    for (auto i { 1 }; i <= 100; ++i) {
+        pool.submit([&sum, i] { sum += i; });
+    }
+    pool.wait();
+    EXPECT_EQ(sum.load(), 5050);
+
+    pool.submit([&sum] { sum = 0; });
+    pool.wait();
+    EXPECT_EQ(sum.load(), 0);
+}
+
+TEST(ThreadPoolTest, waitsForNestedTasks)
+{
+    ThreadPool pool { 3 };
+    std::atomic<int> count { 0 };
+
+    // Each task spawns two children until the tree is 10 levels deep.
+    std::function<void(int)> spawn = [&pool, &count, &spawn](int depth) {
+        ++count;
+        if (depth < 10) {
+            pool.submit([&spawn, depth] { spawn(depth + 1); });
+            pool.submit([&spawn, depth] { spawn(depth + 1); });
+        }
+    };
+    pool.submit([&spawn] { spawn(1); });
+    pool.wait();
+    EXPECT_EQ(count.load(), 1023);
+}
+
+TEST(ThreadPoolTest, destructorDrainsTasks)
+{
+    std::atomic<int> count { 0 };
+    {
+        ThreadPool pool { 0 };
+        EXPECT_EQ(pool.size(), 1);
+        for (auto i { 0 }; i < 50; ++i) {
+            pool.submit([&count] { ++count; });
+        }
+    }
+    EXPECT_EQ(count.load(), 50);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
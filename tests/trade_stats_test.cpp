@@ -0,0 +1,90 @@
+#include "trade_stats.hpp"
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+TEST(TradeStatsTest, session)
+{
+    TradeStats stats { { std::chrono::seconds { 1 } }, 4 };
+    EXPECT_EQ(stats.lastPrice(), Constants::invalidPrice);
+    EXPECT_EQ(stats.session().tradeCount, 0);
+    EXPECT_EQ(stats.session().vwap(), 0.0);
+
+    stats.record(100, 10, 5);
+    stats.record(104, 30, 7);
+    stats.record(98, 10, 9);
+
+    const auto session { stats.session() };
+    EXPECT_EQ(stats.lastPrice(), 98);
+    EXPECT_EQ(session.start, 5);
+    EXPECT_EQ(session.open, 100);
+    EXPECT_EQ(session.high, 104);
+    EXPECT_EQ(session.low, 98);
+    EXPECT_EQ(session.close, 98);
+    EXPECT_EQ(session.volume, 50);
+    EXPECT_EQ(session.tradeCount, 3);
+    EXPECT_DOUBLE_EQ(session.vwap(), 102.0);
+}
+
+TEST(TradeStatsTest, bars)
+{
+    TradeStats stats { { std::chrono::nanoseconds { 10 }, std::chrono::nanoseconds { 100 } }, 3 };
+    EXPECT_EQ(stats.intervals().size(), 2);
+    EXPECT_TRUE(stats.bars(0).empty());
+
+    stats.record(100, 1, 3);
+    stats.record(101, 2, 8);
+    stats.record(99, 3, 12);
+    stats.record(97, 4, 45);
+    stats.record(98, 5, 57);
+
+    auto bars { stats.bars(0) };
+    ASSERT_EQ(bars.size(), 3);
+    EXPECT_EQ(bars[0].start, 10);
+    EXPECT_EQ(bars[1].start, 40);
+    EXPECT_EQ(bars[1].close, 97);
+    EXPECT_EQ(bars[2].start, 50);
+    EXPECT_EQ(bars[2].volume, 5);
+
+    bars = stats.bars(1);
+    ASSERT_EQ(bars.size(), 1);
+    EXPECT_EQ(bars[0].start, 0);
+    EXPECT_EQ(bars[0].open, 100);
+    EXPECT_EQ(bars[0].high, 101);
+    EXPECT_EQ(bars[0].low, 97);
+    EXPECT_EQ(bars[0].close, 98);
+    EXPECT_EQ(bars[0].volume, 15);
+    EXPECT_EQ(bars[0].tradeCount, 5);
+
+    EXPECT_THROW(auto discard { stats.bars(2) }, std::out_of_range);
+    EXPECT_THROW((TradeStats { { std::chrono::seconds { 1 }, std::chrono::seconds { 0 } }, 4 }), std::invalid_argument);
+    EXPECT_THROW((TradeStats { { std::chrono::seconds { -1 } }, 4 }), std::invalid_argument);
+}
+
+TEST(TradeStatsTest, concurrentReads)
+{
+    TradeStats stats { { std::chrono::nanoseconds { 1000 } }, 8 };
+    std::atomic<bool> done { false };
+
+    // Every trade has the same price and quantity, so any torn read shows up as an inconsistent bar.
+    std::thread reader { [&stats, &done] {
+        while (!done.load()) {
+            const auto session { stats.session() };
+            EXPECT_EQ(session.volume, session.tradeCount * 2);
+            EXPECT_EQ(session.notional, session.volume * 50);
+        }
+    } };
+
+    for (Timestamp timestamp { 0 }; timestamp < 100000; ++timestamp) {
+        stats.record(50, 2, timestamp);
+    }
+    done.store(true);
+    reader.join();
+
+    EXPECT_EQ(stats.session().tradeCount, 100000);
+    EXPECT_EQ(stats.bars(0).back().tradeCount, 1000);
+}
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
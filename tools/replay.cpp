@@ -0,0 +1,175 @@
+#include "backtest.hpp"
+#include "capture.hpp"
+#include "replay.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+struct RunOptions {
+    bool paced { false };
+    std::size_t threads { std::thread::hardware_concurrency() };
+    OrderBookOptions bookOptions;
+};
+
+auto printUsage() -> void
+{
+    std::puts("Usage:\n"
+              "  broka_replay convert <input.csv> <output.bin>\n"
+              "  broka_replay run <capture.bin> [--paced] [--lazy-cancel]\n"
+              "  broka_replay backtest <capture.bin> [--threads <count>] [--lazy-cancel]");
+}
+
+auto convert(const char* inputPath, const char* outputPath) -> int
+{
+    std::ifstream input { inputPath };
+    if (!input) {
+        std::fprintf(stderr, "Unable to open %s\n", inputPath); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        return 1;
+    }
+    const auto events { parseCsv(input) };
+    writeCapture(outputPath, events);
+    std::printf("Wrote %zu events to %s\n", events.size(), outputPath); // NOLINT(cppcoreguidelines-pro-type-vararg)
+    return 0;
+}
+
+auto percentile(const std::vector<std::uint64_t>& sorted, double fraction) -> std::uint64_t
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const auto index { static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1)) };
+    return sorted[index];
+}
+
+// Either replays as fast as possible, or sleeps so that each event is applied at its recorded offset from the first.
+auto run(const char* capturePath, const RunOptions& options) -> int
+{
+    using namespace std::chrono; // NOLINT(google-build-using-namespace)
+
+    const Capture capture { capturePath };
+    const auto events { capture.events() };
+
+    Replayer replayer { options.bookOptions };
+    Digest tradeDigest;
+    std::uint64_t tradeCount { 0 };
+    std::vector<std::uint64_t> latencies;
+    latencies.reserve(events.size());
+
+    const auto start { steady_clock::now() };
+    const auto firstTimestamp { events.empty() ? Timestamp { 0 } : events.front().timestamp };
+
+    for (const auto& event : events) {
+        if (options.paced) {
+            std::this_thread::sleep_until(start + nanoseconds { event.timestamp - firstTimestamp });
+        }
+
+        const auto before { steady_clock::now() };
+        const auto trades { replayer.apply(event) };
+        const auto after { steady_clock::now() };
+
+        latencies.emplace_back(duration_cast<nanoseconds>(after - before).count());
+        tradeCount += trades.size();
+        for (const auto& trade : trades) {
+            tradeDigest.add(trade);
+        }
+    }
+
+    const auto elapsed { duration<double> { steady_clock::now() - start }.count() };
+    std::ranges::sort(latencies);
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-vararg, cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+    std::printf("events:       %zu\n", events.size());
+    std::printf("books:        %zu\n", replayer.bookCount());
+    std::printf("trades:       %lu\n", tradeCount);
+    std::printf("elapsed:      %.3f s\n", elapsed);
+    std::printf("throughput:   %.0f events/s\n", elapsed > 0 ? static_cast<double>(events.size()) / elapsed : 0.0);
+    std::printf("latency (ns): p50 %lu, p90 %lu, p99 %lu, p99.9 %lu, max %lu\n",
+        percentile(latencies, 0.5), percentile(latencies, 0.9), percentile(latencies, 0.99),
+        percentile(latencies, 0.999), latencies.empty() ? 0 : latencies.back());
+    std::printf("book digest:  %016lx\n", replayer.bookDigest());
+    std::printf("trade digest: %016lx\n", tradeDigest.value());
+    // NOLINTEND(cppcoreguidelines-pro-type-vararg, cppcoreguidelines-avoid-magic-numbers, readability-magic-numbers)
+    return 0;
+}
+
+// Replays each instrument's events in parallel, so only the per-book outcome (not the global trade order) is reported.
+auto backtest(const char* capturePath, const RunOptions& options) -> int
+{
+    using namespace std::chrono; // NOLINT(google-build-using-namespace)
+
+    const Capture capture { capturePath };
+    const auto streams { splitByInstrument(capture.events()) };
+
+    const auto start { steady_clock::now() };
+    const auto result { runBacktest(streams, { .threads = options.threads, .bookOptions = options.bookOptions }) };
+    const auto elapsed { duration<double> { steady_clock::now() - start }.count() };
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-vararg)
+    std::printf("events:       %zu\n", result.eventCount);
+    std::printf("books:        %zu\n", result.books.size());
+    std::printf("threads:      %zu\n", options.threads);
+    std::printf("trades:       %zu\n", result.tradeCount);
+    std::printf("volume:       %lu\n", result.volume);
+    std::printf("elapsed:      %.3f s\n", elapsed);
+    std::printf("throughput:   %.0f events/s\n", elapsed > 0 ? static_cast<double>(result.eventCount) / elapsed : 0.0);
+    std::printf("book digest:  %016lx\n", result.bookDigest);
+    std::printf("trade digest: %016lx (by instrument)\n", result.tradeDigest);
+    // NOLINTEND(cppcoreguidelines-pro-type-vararg)
+    return 0;
+}
+
+auto parseRunOptions(std::span<char*> flags) -> std::optional<RunOptions>
+{
+    RunOptions options;
+    for (std::size_t i { 0 }; i < flags.size(); ++i) {
+        const std::string_view flag { flags[i] };
+        if (flag == "--paced") {
+            options.paced = true;
+        } else if (flag == "--lazy-cancel") {
+            options.bookOptions.cancelMode = CancelMode::lazy;
+        } else if (flag == "--threads" && i + 1 < flags.size()) {
+            options.threads = std::stoul(flags[++i]);
+        } else {
+            return std::nullopt;
+        }
+    }
+    return options;
+}
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+    const std::span args { argv, static_cast<std::size_t>(argc) };
+
+    try {
+        if (args.size() == 4 && std::string_view { args[1] } == "convert") {
+            return convert(args[2], args[3]);
+        }
+        if (args.size() >= 3) {
+            const std::string_view command { args[1] };
+            const auto options { parseRunOptions(args.subspan(3)) };
+            if (options && command == "run") {
+                return run(args[2], *options);
+            }
+            if (options && command == "backtest" && !options->paced) {
+                return backtest(args[2], *options);
+            }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s\n", e.what()); // NOLINT(cppcoreguidelines-pro-type-vararg)
+        return 1;
+    }
+
+    printUsage();
+    return 1;
+}